@@ -0,0 +1,180 @@
+#include "lte-quic-tcp-scenario.h"
+#include "replication-runner.h"
+
+using namespace ns3;
+
+/**
+ * This is a simulation script for LTE+EPC. It instantiates one eNodeB, attaches TCP UEs and QUIC UEs to the eNodeB,
+ * and starts N TCP flows from a TCP remote host to the TCP UEs and M QUIC flows from a QUIC remote host to the QUIC UEs.
+ * The flows of a protocol are spread round-robin over its UEs. The QUIC flows of a UE are separate connections to
+ * the same port, so --quicUes=1 runs all the QUIC flows on a single UE.
+ *
+ * Besides the throughput of every flow, it reports Jain's fairness index of the flows and the ratio of the mean QUIC
+ * flow throughput to the mean TCP flow throughput, over the whole run and over sliding windows (--fairnessWindow):
+ * the windows before and after the steady state of all the flows tell transient and steady-state unfairness apart.
+ *
+ * The defaults are the 1 QUIC vs 5 TCPs scenario of the article; --tcpFlows=2 is the 1 QUIC vs 2 TCPs one.
+ */
+
+int
+main(int argc, char* argv[])
+{
+    double distance = 250; // Default distance value.
+    std::string internetDataRate = "1Gbps"; // The data rate of the PGW <-> remote hosts links.
+    uint32_t tcpFlows = 5;
+    uint32_t quicFlows = 1;
+    uint32_t tcpUes = 1;
+    uint32_t quicUes = 1;
+    double tcpStartTime = 0;
+    double quicStartTime = 2;
+    double startInterval = 0; // Between the starts of consecutive flows of the same protocol.
+    double fairnessWindow = 1; // The sliding window of the fairness time series, in seconds.
+
+    LteQuicTcpScenarioConfig config;
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("distance", "Distance between nodes (in meters)", distance);
+    cmd.AddValue("internetDataRate", "Data rate of the links between the PGW and the remote hosts", internetDataRate);
+    cmd.AddValue("tcpFlows", "Number of TCP flows", tcpFlows);
+    cmd.AddValue("quicFlows", "Number of QUIC flows", quicFlows);
+    cmd.AddValue("tcpUes", "Number of UEs the TCP flows are spread over", tcpUes);
+    cmd.AddValue("quicUes", "Number of UEs the QUIC flows are spread over", quicUes);
+    cmd.AddValue("tcpStartTime", "Start time of the first TCP flow (in seconds)", tcpStartTime);
+    cmd.AddValue("quicStartTime", "Start time of the first QUIC flow (in seconds)", quicStartTime);
+    cmd.AddValue("startInterval", "Time between the starts of consecutive flows of a protocol (in seconds)",
+                 startInterval);
+    cmd.AddValue("fairnessWindow", "The duration of the sliding windows the fairness is computed over (in seconds)",
+                 fairnessWindow);
+    config.AddCommandLineValues(cmd);
+    ReplicationRunner runner;
+    runner.AddCommandLineValues(cmd);
+    cmd.Parse(argc, argv);
+    runner.SetParameters(config.GetParameters());
+
+    NS_ABORT_MSG_IF(tcpFlows + quicFlows == 0, "At least one flow is needed");
+    NS_ABORT_MSG_IF(tcpFlows > 600, "At most 600 TCP flows are supported (one port per 100)");
+    NS_ABORT_MSG_IF((tcpFlows > 0 && tcpUes == 0) || (quicFlows > 0 && quicUes == 0),
+                    "The flows of a protocol need at least one UE");
+    runner.SetParameter("distance", distance);
+    runner.SetParameter("internetDataRate", internetDataRate);
+    runner.SetParameter("tcpFlows", tcpFlows);
+    runner.SetParameter("quicFlows", quicFlows);
+    runner.SetParameter("tcpUes", tcpUes);
+    runner.SetParameter("quicUes", quicUes);
+    runner.SetParameter("tcpStartTime", tcpStartTime);
+    runner.SetParameter("quicStartTime", quicStartTime);
+    runner.SetParameter("startInterval", startInterval);
+
+    config.internetDataRate = internetDataRate;
+    config.remoteHosts = {TransportProtocol::TCP, TransportProtocol::QUIC};
+
+    // The UEs are all at the same distance from the eNB: the TCP UEs in the first quarter of the circle,
+    // from (distance, 0), and the QUIC UEs in the second one, from (0, distance).
+    for (uint32_t i = 0; i < tcpUes; ++i)
+    {
+        double angle = M_PI / 2 * i / tcpUes;
+        config.ues.push_back({TransportProtocol::TCP, Vector(distance * std::cos(angle), distance * std::sin(angle), 0.0)});
+    }
+    for (uint32_t i = 0; i < quicUes; ++i)
+    {
+        double angle = M_PI / 2 * (1 + static_cast<double>(i) / quicUes);
+        config.ues.push_back({TransportProtocol::QUIC, Vector(distance * std::cos(angle), distance * std::sin(angle), 0.0)});
+    }
+
+    // The flow table: the TCP flows on ports 1100, 1200, ..., then the QUIC flows, all on the next port:
+    for (uint32_t i = 0; i < tcpFlows; ++i)
+    {
+        config.flows.push_back({0, i % tcpUes, static_cast<uint16_t>(1100 + 100 * i), 0, tcpStartTime + i * startInterval});
+    }
+    for (uint32_t i = 0; i < quicFlows; ++i)
+    {
+        config.flows.push_back({1,
+                                tcpUes + i % quicUes,
+                                static_cast<uint16_t>(1100 + 100 * tcpFlows),
+                                0,
+                                quicStartTime + i * startInterval});
+    }
+
+    return runner.Run([&config, tcpFlows, fairnessWindow](ReplicationKpis& kpis) {
+        LteQuicTcpScenario scenario(config);
+        scenario.Build();
+        scenario.Run();
+
+        for (uint32_t i = 0; i < config.flows.size(); ++i)
+        {
+            std::string protocol = i < tcpFlows ? "TCP" : "QUIC";
+            uint32_t number = i < tcpFlows ? i + 1 : i - tcpFlows + 1;
+            std::cout << protocol << " FLOW " << number << " THROUGHTPUT: " << scenario.GetThroughput(i) << std::endl;
+            kpis.Add((i < tcpFlows ? "tcpFlow" : "quicFlow") + std::to_string(number), scenario.GetThroughput(i));
+        }
+        for (uint32_t i = 0; i < config.flows.size(); ++i)
+        {
+            kpis.Record("flow" + std::to_string(i) + "Bytes", scenario.GetReceivedBytes(i));
+            kpis.Record("flow" + std::to_string(i) + "SteadyStateThroughput",
+                        scenario.GetSteadyStateThroughput(i).throughput);
+        }
+
+        // The fairness over the whole run, and separately before and after all the flows reached their steady state:
+        FairnessSample fairness = scenario.GetFairness();
+        std::cout << "JAIN INDEX: " << fairness.jainIndex << std::endl;
+        kpis.Add("jainIndex", fairness.jainIndex);
+        if (!std::isnan(fairness.shareRatio))
+        {
+            std::cout << "QUIC/TCP SHARE RATIO: " << fairness.shareRatio << std::endl;
+            kpis.Add("quicTcpShareRatio", fairness.shareRatio);
+        }
+        double steadyStateStart = 0;
+        for (uint32_t i = 0; i < config.flows.size(); ++i)
+        {
+            steadyStateStart = std::max(steadyStateStart, scenario.GetSteadyStateThroughput(i).start);
+        }
+        RunningStatistics transientJainIndex;
+        RunningStatistics steadyStateJainIndex;
+        RunningStatistics steadyStateShareRatio;
+        double minJainIndex = 1;
+        for (const FairnessSample& window : scenario.GetFairnessTimeSeries(fairnessWindow))
+        {
+            if (std::isnan(window.jainIndex))
+            {
+                continue; // No flow has started yet.
+            }
+            minJainIndex = std::min(minJainIndex, window.jainIndex);
+            if (window.time < steadyStateStart)
+            {
+                transientJainIndex.Add(window.jainIndex);
+            }
+            else
+            {
+                steadyStateJainIndex.Add(window.jainIndex);
+                if (!std::isnan(window.shareRatio))
+                {
+                    steadyStateShareRatio.Add(window.shareRatio);
+                }
+            }
+        }
+        kpis.Record("minJainIndex", minJainIndex);
+        kpis.Record("steadyStateStart", steadyStateStart);
+        if (transientJainIndex.GetCount() > 0)
+        {
+            kpis.Record("transientJainIndex", transientJainIndex.GetMean());
+        }
+        if (steadyStateJainIndex.GetCount() > 0)
+        {
+            kpis.Add("steadyStateJainIndex", steadyStateJainIndex.GetMean());
+        }
+        if (steadyStateShareRatio.GetCount() > 0)
+        {
+            kpis.Add("steadyStateShareRatio", steadyStateShareRatio.GetMean());
+        }
+        kpis.Record("duration", scenario.GetDuration());
+        if (scenario.GetConfig().profile)
+        {
+            kpis.Record(scenario.GetProfile().GetValues());
+        }
+        if (scenario.GetConfig().latency)
+        {
+            kpis.Record(scenario.GetLatencyValues());
+        }
+        Simulator::Destroy();
+        return true;
+    });
+}
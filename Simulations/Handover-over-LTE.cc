@@ -0,0 +1,158 @@
+#include "lte-quic-tcp-scenario.h"
+#include "replication-runner.h"
+
+using namespace ns3;
+
+/**
+ * This is a simulation script for LTE+EPC. It instantiates K eNodeBs on a hexagonal grid, connected by X2,
+ * and N UEs that move by random waypoint over the grid and are handed over between the cells. Every UE
+ * receives one TCP flow from a TCP remote host and one QUIC flow from a QUIC remote host.
+ *
+ * Besides the mean throughput of the flows of each protocol and their fairness, it reports the number of
+ * handovers and how the flows of each protocol recover from them: the ratio of the throughput of a flow in
+ * the --handoverWindow after the handover to its throughput in the same window before it.
+ *
+ * The UEs of a large grid outnumber the default SRS slots of a cell, which the scenario enlarges (up to 320);
+ * --fadingTrace=none leaves out the trace fading, the costliest per-UE part of the PHY.
+ */
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t enbs = 7; // The center cell and its first ring.
+    double interSiteDistance = 500; // In meters.
+    uint32_t ues = 100;
+    double speed = 10; // In m/s.
+    double tcpStartTime = 0;
+    double quicStartTime = 0;
+    double startInterval = 0.01; // Between the starts of the flows of consecutive UEs.
+    double handoverWindow = 1; // In seconds.
+
+    LteQuicTcpScenarioConfig config;
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("enbs", "Number of eNBs, on a hexagonal grid", enbs);
+    cmd.AddValue("interSiteDistance", "Distance between neighbouring eNBs (in meters)", interSiteDistance);
+    cmd.AddValue("ues", "Number of UEs", ues);
+    cmd.AddValue("speed", "Speed of the UEs (in m/s)", speed);
+    cmd.AddValue("tcpStartTime", "Start time of the TCP flow of the first UE (in seconds)", tcpStartTime);
+    cmd.AddValue("quicStartTime", "Start time of the QUIC flow of the first UE (in seconds)", quicStartTime);
+    cmd.AddValue("startInterval", "Time between the starts of the flows of consecutive UEs (in seconds)",
+                 startInterval);
+    cmd.AddValue("handoverWindow", "The windows before and after a handover its throughput drop is measured over "
+                 "(in seconds)", handoverWindow);
+    config.AddCommandLineValues(cmd);
+    ReplicationRunner runner;
+    runner.AddCommandLineValues(cmd);
+    cmd.Parse(argc, argv);
+    runner.SetParameters(config.GetParameters());
+
+    NS_ABORT_MSG_IF(enbs == 0 || ues == 0, "At least one eNB and one UE are needed");
+    NS_ABORT_MSG_IF(speed <= 0, "The UEs must move");
+    runner.SetParameter("enbs", enbs);
+    runner.SetParameter("interSiteDistance", interSiteDistance);
+    runner.SetParameter("ues", ues);
+    runner.SetParameter("speed", speed);
+
+    config.remoteHosts = {TransportProtocol::TCP, TransportProtocol::QUIC};
+
+    // The UEs roam over the bounding box of the cells:
+    config.enbPositions = GetHexGridPositions(enbs, interSiteDistance);
+    Rectangle& area = config.mobilityArea;
+    area = Rectangle(0, 0, 0, 0);
+    for (const Vector& position : config.enbPositions)
+    {
+        area.xMin = std::min(area.xMin, position.x - interSiteDistance / 2);
+        area.xMax = std::max(area.xMax, position.x + interSiteDistance / 2);
+        area.yMin = std::min(area.yMin, position.y - interSiteDistance / 2);
+        area.yMax = std::max(area.yMax, position.y + interSiteDistance / 2);
+    }
+
+    // The flow table: the TCP flow of UE i on port 1100 is flow 2i, its QUIC flow on port 1200 is flow 2i + 1.
+    // The QUIC stack of the UEs includes the TCP one.
+    for (uint32_t i = 0; i < ues; ++i)
+    {
+        ScenarioUe ue{TransportProtocol::QUIC, Vector(0.0, 0.0, 0.0)};
+        ue.speed = speed;
+        config.ues.push_back(ue);
+        config.flows.push_back({0, i, 1100, 0, tcpStartTime + i * startInterval});
+        config.flows.push_back({1, i, 1200, 0, quicStartTime + i * startInterval});
+    }
+
+    return runner.Run([&config, handoverWindow](ReplicationKpis& kpis) {
+        LteQuicTcpScenario scenario(config);
+        scenario.Build();
+        scenario.Run();
+
+        RunningStatistics throughputs[2]; // TCP, then QUIC.
+        std::vector<std::vector<ThroughputSample>> series;
+        for (uint32_t flow = 0; flow < config.flows.size(); ++flow)
+        {
+            throughputs[flow % 2].Add(scenario.GetThroughputSinceStart(flow));
+            series.push_back(scenario.GetTimeSeries(flow));
+        }
+
+        // The throughput of the flows of a UE after each of its handovers, relative to before it:
+        RunningStatistics recoveries[2];
+        uint32_t completedHandovers = 0;
+        for (const ScenarioHandover& handover : scenario.GetHandovers())
+        {
+            if (handover.endTime < 0)
+            {
+                continue;
+            }
+            ++completedHandovers;
+            for (uint32_t protocol = 0; protocol < 2; ++protocol)
+            {
+                uint32_t flow = 2 * handover.ue + protocol;
+                double start = scenario.GetStartTime(flow);
+                if (start < 0 || start > handover.startTime - handoverWindow)
+                {
+                    continue; // The window before the handover is not all in the flow.
+                }
+                double before =
+                    GetMeanThroughput(series[flow], handover.startTime - handoverWindow, handover.startTime);
+                double after = GetMeanThroughput(series[flow], handover.endTime, handover.endTime + handoverWindow);
+                if (before > 0 && !std::isnan(after))
+                {
+                    recoveries[protocol].Add(after / before);
+                }
+            }
+        }
+        FairnessSample fairness = scenario.GetFairness();
+        uint32_t handovers = scenario.GetHandovers().size();
+        double duration = scenario.GetDuration();
+        if (scenario.GetConfig().profile)
+        {
+            kpis.Record(scenario.GetProfile().GetValues());
+        }
+        if (scenario.GetConfig().latency)
+        {
+            kpis.Record(scenario.GetLatencyValues());
+        }
+        Simulator::Destroy();
+
+        std::cout << "TCP THROUGHPUT: " << throughputs[0].GetMean() << std::endl;
+        std::cout << "QUIC THROUGHPUT: " << throughputs[1].GetMean() << std::endl;
+        std::cout << "JAIN INDEX: " << fairness.jainIndex << std::endl;
+        std::cout << "HANDOVERS: " << completedHandovers << std::endl;
+        kpis.Add("tcpThroughput", throughputs[0].GetMean());
+        kpis.Add("quicThroughput", throughputs[1].GetMean());
+        kpis.Add("jainIndex", fairness.jainIndex);
+        if (!std::isnan(fairness.shareRatio))
+        {
+            kpis.Add("quicTcpShareRatio", fairness.shareRatio);
+        }
+        kpis.Add("handovers", completedHandovers);
+        if (recoveries[0].GetCount() > 0)
+        {
+            kpis.Add("tcpHandoverRecovery", recoveries[0].GetMean());
+        }
+        if (recoveries[1].GetCount() > 0)
+        {
+            kpis.Add("quicHandoverRecovery", recoveries[1].GetMean());
+        }
+        kpis.Record("failedHandovers", handovers - completedHandovers);
+        kpis.Record("duration", duration);
+        return true;
+    });
+}
@@ -0,0 +1,74 @@
+#include "lte-quic-tcp-scenario.h"
+#include "replication-runner.h"
+
+using namespace ns3;
+
+/**
+ * This is a simulation script for LTE+EPC. It instantiates one eNodeB, attaches one UE to the eNodeB,
+ * and starts several concurrent QUIC connections from a remote host to the same port of the UE, where
+ * a single PacketSink accepts them all (what FailedAttempts/TwoQuicConnectionsSameReceiver.cc tried).
+ *
+ * It reports the aggregate throughput of the connections, the throughput of every connection, and Jain's
+ * fairness index of the connections.
+ */
+
+int
+main(int argc, char* argv[])
+{
+    double distance = 250;    // Default distance value.
+    uint32_t connections = 2; // Default number of QUIC connections.
+
+    LteQuicTcpScenarioConfig config;
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("distance", "Distance between nodes (in meters)", distance);
+    cmd.AddValue("connections", "Number of QUIC connections to the UE", connections);
+    config.AddCommandLineValues(cmd);
+    ReplicationRunner runner;
+    runner.AddCommandLineValues(cmd);
+    cmd.Parse(argc, argv);
+    runner.SetParameters(config.GetParameters());
+    NS_ABORT_MSG_IF(connections == 0, "At least one connection is needed");
+    runner.SetParameter("distance", distance);
+    runner.SetParameter("connections", connections);
+
+    config.remoteHosts = {TransportProtocol::QUIC};
+    config.ues = {{TransportProtocol::QUIC, Vector(distance, 0.0, 0.0)}};
+    // 'connections' unlimited QUIC flows from the remote host to 'UE-0' on port 1100, starting at 2s:
+    config.flows.assign(connections, {0, 0, 1100, 0, 2});
+
+    return runner.Run([&config, connections](ReplicationKpis& kpis) {
+        LteQuicTcpScenario scenario(config);
+        scenario.Build();
+        scenario.Run();
+
+        double quicThroughput = 0; // Throughput in Mbps
+        std::vector<double> connectionThroughputs;
+        for (uint32_t i = 0; i < connections; ++i)
+        {
+            connectionThroughputs.push_back(scenario.GetThroughput(i));
+            quicThroughput += connectionThroughputs.back();
+            kpis.Record("flow" + std::to_string(i) + "Bytes", scenario.GetReceivedBytes(i));
+        }
+        double duration = scenario.GetDuration();
+        if (scenario.GetConfig().profile)
+        {
+            kpis.Record(scenario.GetProfile().GetValues());
+        }
+        if (scenario.GetConfig().latency)
+        {
+            kpis.Record(scenario.GetLatencyValues());
+        }
+        Simulator::Destroy();
+
+        std::cout << quicThroughput << std::endl;
+        for (uint32_t i = 0; i < connections; ++i)
+        {
+            std::cout << "CONNECTION " << i + 1 << " THROUGHPUT: " << connectionThroughputs[i] << std::endl;
+            kpis.Record("connection" + std::to_string(i + 1) + "Throughput", connectionThroughputs[i]);
+        }
+        kpis.Add("throughput", quicThroughput);
+        kpis.Add("connectionJainIndex", JainFairnessIndex(connectionThroughputs));
+        kpis.Record("duration", duration);
+        return true;
+    });
+}
@@ -0,0 +1,77 @@
+#include "lte-quic-tcp-scenario.h"
+#include "replication-runner.h"
+
+using namespace ns3;
+
+/**
+ * This is a simulation script for LTE+EPC. It instantiates one eNodeB, attaches one UE to the eNodeB,
+ * and starts a QUIC flow from a remote host to the UE over the LTE RAN, with its data multiplexed over
+ * several streams of the same connection.
+ *
+ * It reports the aggregate throughput of the connection, the throughput of every stream, and Jain's
+ * fairness index of the streams.
+ */
+
+int
+main(int argc, char* argv[])
+{
+    double distance = 250; // Default distance value.
+    uint32_t streams = 4;  // Default number of streams.
+
+    LteQuicTcpScenarioConfig config;
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("distance", "Distance between nodes (in meters)", distance);
+    cmd.AddValue("streams", "Number of QUIC streams of the connection", streams);
+    config.AddCommandLineValues(cmd);
+    ReplicationRunner runner;
+    runner.AddCommandLineValues(cmd);
+    cmd.Parse(argc, argv);
+    runner.SetParameters(config.GetParameters());
+    NS_ABORT_MSG_IF(streams == 0, "At least one stream is needed");
+    runner.SetParameter("distance", distance);
+    runner.SetParameter("streams", streams);
+
+    config.remoteHosts = {TransportProtocol::QUIC};
+    config.ues = {{TransportProtocol::QUIC, Vector(distance, 0.0, 0.0)}};
+    // An unlimited QUIC flow from the remote host to 'UE-0' on port 1100, starting at 2s, over 'streams' streams:
+    config.flows = {{0, 0, 1100, 0, 2, -1, streams}};
+
+    return runner.Run([&config, streams](ReplicationKpis& kpis) {
+        LteQuicTcpScenario scenario(config);
+        scenario.Build();
+        scenario.Run();
+
+        double quicThroughput = scenario.GetThroughput(0); // Throughput in Mbps
+        SteadyStateThroughput steadyState = scenario.GetSteadyStateThroughput(0);
+        std::vector<double> streamThroughputs;
+        for (uint32_t streamId = 1; streamId <= streams; ++streamId)
+        {
+            streamThroughputs.push_back(scenario.GetStreamThroughput(0, streamId));
+        }
+        uint64_t receivedBytes = scenario.GetReceivedBytes(0);
+        double duration = scenario.GetDuration();
+        if (scenario.GetConfig().profile)
+        {
+            kpis.Record(scenario.GetProfile().GetValues());
+        }
+        if (scenario.GetConfig().latency)
+        {
+            kpis.Record(scenario.GetLatencyValues());
+        }
+        Simulator::Destroy();
+
+        std::cout << quicThroughput << std::endl;
+        for (uint32_t i = 0; i < streams; ++i)
+        {
+            std::cout << "STREAM " << i + 1 << " THROUGHPUT: " << streamThroughputs[i] << std::endl;
+            kpis.Record("stream" + std::to_string(i + 1) + "Throughput", streamThroughputs[i]);
+        }
+        kpis.Add("throughput", quicThroughput);
+        kpis.Add("steadyStateThroughput", steadyState.throughput);
+        kpis.Add("streamJainIndex", JainFairnessIndex(streamThroughputs));
+        kpis.Record("steadyStateStart", steadyState.start);
+        kpis.Record("duration", duration);
+        kpis.Record("flow0Bytes", receivedBytes);
+        return true;
+    });
+}
@@ -0,0 +1,349 @@
+#ifndef FADING_GENERATOR_H
+#define FADING_GENERATOR_H
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+/**
+ * The binary fading traces loaded by fading-trace.h, and a generator of synthetic ones.
+ *
+ * A binary trace is:
+ *
+ *   FadingTraceHeader + float[samplesNum][rbNum]  (in native byte order)
+ *
+ * whose values are the linear power gains of the resource blocks at every sample, sample by sample. A trace with
+ * the FADING_TRACE_CONTINUOUS flag is one continuous realization of the fading, which every link plays from a
+ * random start without jumping (the generated ones); the others are a pool of windows of a trace (the converted
+ * ones of ns-3), see MappedTraceFadingLossModel.
+ *
+ * The generator draws the fading of the multipath profiles of 3GPP TS 36.104 Annex B (EPA, EVA and ETU) at any
+ * Doppler frequency and length: every tap of the profile is a Rayleigh process with the Jakes spectrum (the sum of
+ * sinusoids of Zheng and Xiao), and the gain of an RB is the power of the frequency response of the taps at its
+ * centre. So the traces are as long as the simulations, instead of wrapping around like the 10 s traces of ns-3, at
+ * the speed of the scenario. The traces are deterministic functions of their parameters, and cached in a directory
+ * under a hash of them, so the runs of a sweep generate a trace once and then map it.
+ *
+ * This header does not depend on ns-3, so that Utils/Tools/fading-generator.cc builds without it.
+ */
+
+namespace ns3
+{
+
+struct FadingTraceHeader
+{
+    char magic[8];         // "FADTRACE".
+    uint32_t version;      // FADING_TRACE_VERSION.
+    uint32_t rbNum;        // The resource blocks, per sample.
+    uint32_t samplesNum;   // The samples of the trace.
+    uint32_t flags;        // FADING_TRACE_CONTINUOUS, or zero.
+    double sampleInterval; // In seconds.
+};
+
+static_assert(sizeof(FadingTraceHeader) == 32, "FadingTraceHeader must have no hidden padding");
+
+constexpr uint32_t FADING_TRACE_VERSION = 1;
+constexpr uint32_t FADING_TRACE_CONTINUOUS = 1; // The links play the trace continuously, see the flags.
+
+/**
+ * The 64-bit FNV-1a hash of a string, which names the cached traces: unlike std::hash, it is the same in every
+ * build, so the caches stay valid across builds.
+ */
+inline uint64_t
+GetFadingTraceHash(const std::string& key)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : key)
+    {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * Write a binary fading trace of the linear power gains gains[sample * rbNum + rb]. It is written to a temporary
+ * file then renamed, so that the concurrent workers of a sweep never map a partial trace.
+ */
+inline void
+WriteFadingTrace(const std::string& filename,
+                 uint32_t rbNum,
+                 uint32_t samplesNum,
+                 double sampleInterval,
+                 const std::vector<float>& gains,
+                 uint32_t flags = 0)
+{
+    if (gains.size() != static_cast<size_t>(rbNum) * samplesNum)
+    {
+        throw std::invalid_argument("A fading trace of " + std::to_string(samplesNum) + " samples of " +
+                                    std::to_string(rbNum) + " RBs needs as many gains");
+    }
+    FadingTraceHeader header = {};
+    std::memcpy(header.magic, "FADTRACE", sizeof(header.magic));
+    header.version = FADING_TRACE_VERSION;
+    header.rbNum = rbNum;
+    header.samplesNum = samplesNum;
+    header.flags = flags;
+    header.sampleInterval = sampleInterval;
+
+    std::string temporary = filename + ".tmp." + std::to_string(getpid());
+    std::ofstream file(temporary, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Cannot create the fading trace " + temporary);
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(gains.data()), gains.size() * sizeof(float));
+    file.close();
+    if (!file || std::rename(temporary.c_str(), filename.c_str()) != 0)
+    {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Cannot write the fading trace " + filename);
+    }
+}
+
+/**
+ * The parameters of a synthetic fading trace.
+ */
+struct FadingTraceParameters
+{
+    std::string profile = "EPA";   // The multipath profile: EPA, EVA or ETU.
+    double doppler = 5;            // The maximum Doppler frequency, in Hz.
+    double duration = 60;          // In seconds.
+    double sampleInterval = 0.001; // In seconds: a TTI.
+    uint32_t rbNum = 100;          // The RBs of a 20 MHz carrier.
+    uint32_t sinusoids = 16;       // Per tap and per component (in-phase and quadrature).
+    uint64_t seed = 1;
+
+    /**
+     * All the parameters, which identify the trace.
+     */
+    std::string GetKey() const
+    {
+        std::ostringstream key;
+        key.precision(17);
+        key << "fading-generator-2 profile=" << profile << " doppler=" << doppler << " duration=" << duration
+            << " sampleInterval=" << sampleInterval << " rbNum=" << rbNum << " sinusoids=" << sinusoids
+            << " seed=" << seed;
+        return key.str();
+    }
+};
+
+/**
+ * The maximum Doppler frequency (in Hz) of a UE moving at a speed (in km/h), at a carrier frequency (in Hz, by
+ * default the 2120 MHz of the downlink EARFCN 100, the default of ns-3).
+ */
+inline double
+GetDopplerFrequency(double speed, double carrierFrequency = 2.12e9)
+{
+    return speed / 3.6 * carrierFrequency / 299792458.0;
+}
+
+/**
+ * Parse a synthetic trace of a simulation: <profile>[:<Doppler in Hz>[:<duration in s>]], e.g. EVA:70:60. Return
+ * false if the trace does not name a profile of the generator.
+ */
+inline bool
+ParseFadingTraceSpec(const std::string& spec, FadingTraceParameters& parameters)
+{
+    std::istringstream fields(spec);
+    std::string profile;
+    std::getline(fields, profile, ':');
+    if (profile != "EPA" && profile != "EVA" && profile != "ETU")
+    {
+        return false;
+    }
+    parameters.profile = profile;
+    std::string field;
+    for (double* value : {&parameters.doppler, &parameters.duration})
+    {
+        if (!std::getline(fields, field, ':'))
+        {
+            break;
+        }
+        size_t end = 0;
+        try
+        {
+            *value = std::stod(field, &end);
+        }
+        catch (const std::exception&)
+        {
+            end = 0;
+        }
+        if (end == 0 || end != field.size())
+        {
+            throw std::invalid_argument("Invalid fading trace " + spec + ": expected <profile>:<doppler>:<duration>");
+        }
+    }
+    if (std::getline(fields, field))
+    {
+        throw std::invalid_argument("Invalid fading trace " + spec + ": expected <profile>:<doppler>:<duration>");
+    }
+    return true;
+}
+
+/**
+ * Generate the linear power gains of a synthetic trace, gains[sample * rbNum + rb], normalized to a mean of one.
+ */
+inline std::vector<float>
+GenerateFadingTrace(const FadingTraceParameters& parameters)
+{
+    // The tap delays (in ns) and powers (in dB) of the profiles, TS 36.104 Table B.2.1-2 to B.2.1-4:
+    std::vector<double> delays;
+    std::vector<double> powers;
+    if (parameters.profile == "EPA")
+    {
+        delays = {0, 30, 70, 90, 110, 190, 410};
+        powers = {0.0, -1.0, -2.0, -3.0, -8.0, -17.2, -20.8};
+    }
+    else if (parameters.profile == "EVA")
+    {
+        delays = {0, 30, 150, 310, 370, 710, 1090, 1730, 2510};
+        powers = {0.0, -1.5, -1.4, -3.6, -0.6, -9.1, -7.0, -12.0, -16.9};
+    }
+    else if (parameters.profile == "ETU")
+    {
+        delays = {0, 50, 120, 200, 230, 500, 1600, 2300, 5000};
+        powers = {-1.0, -1.0, -1.0, 0.0, 0.0, 0.0, -3.0, -5.0, -7.0};
+    }
+    else
+    {
+        throw std::invalid_argument("Unknown fading profile " + parameters.profile + " (EPA, EVA or ETU)");
+    }
+    if (parameters.doppler < 0 || !(parameters.duration > 0) || !(parameters.sampleInterval > 0) ||
+        parameters.duration / parameters.sampleInterval < 1 || parameters.rbNum == 0 || parameters.sinusoids == 0)
+    {
+        throw std::invalid_argument("Invalid fading trace parameters: " + parameters.GetKey());
+    }
+    auto samplesNum = static_cast<uint32_t>(std::llround(parameters.duration / parameters.sampleInterval));
+    uint32_t taps = delays.size();
+    uint32_t rbNum = parameters.rbNum;
+    uint32_t sinusoids = parameters.sinusoids;
+
+    // The response of every tap at the centre of every RB, scaled by the amplitude of the tap:
+    double totalPower = 0;
+    for (double power : powers)
+    {
+        totalPower += std::pow(10, power / 10);
+    }
+    std::vector<std::complex<double>> responses(static_cast<size_t>(taps) * rbNum);
+    for (uint32_t tap = 0; tap < taps; ++tap)
+    {
+        double amplitude = std::sqrt(std::pow(10, powers[tap] / 10) / totalPower);
+        for (uint32_t rb = 0; rb < rbNum; ++rb)
+        {
+            double frequency = (rb + 0.5 - rbNum / 2.0) * 180e3;
+            responses[tap * rbNum + rb] = std::polar(amplitude, -2 * M_PI * frequency * delays[tap] * 1e-9);
+        }
+    }
+
+    // The sum of sinusoids of every tap: the angles of arrival of its paths, and their phases. The uniform
+    // variates are drawn from the bits of mt19937_64, whose sequence is the same in every standard library:
+    std::mt19937_64 random(parameters.seed);
+    auto uniform = [&random]() { return (random() >> 11) * 0x1.0p-53 * 2 * M_PI - M_PI; };
+    std::vector<double> inPhaseFrequencies(static_cast<size_t>(taps) * sinusoids);
+    std::vector<double> quadratureFrequencies(inPhaseFrequencies.size());
+    std::vector<double> inPhasePhases(inPhaseFrequencies.size());
+    std::vector<double> quadraturePhases(inPhaseFrequencies.size());
+    for (uint32_t tap = 0; tap < taps; ++tap)
+    {
+        double theta = uniform();
+        for (uint32_t n = 0; n < sinusoids; ++n)
+        {
+            double alpha = (2 * M_PI * (n + 1) - M_PI + theta) / (4 * sinusoids);
+            size_t i = static_cast<size_t>(tap) * sinusoids + n;
+            inPhaseFrequencies[i] = 2 * M_PI * parameters.doppler * std::cos(alpha);
+            quadratureFrequencies[i] = 2 * M_PI * parameters.doppler * std::sin(alpha);
+            inPhasePhases[i] = uniform();
+            quadraturePhases[i] = uniform();
+        }
+    }
+
+    std::vector<float> gains(static_cast<size_t>(samplesNum) * rbNum);
+    std::vector<std::complex<double>> tapGains(taps);
+    std::vector<std::complex<double>> rbResponses(rbNum);
+    double scale = std::sqrt(1.0 / sinusoids); // Each component has a variance of 1/2, the tap a power of one.
+    double sum = 0;
+    for (uint32_t sample = 0; sample < samplesNum; ++sample)
+    {
+        double time = sample * parameters.sampleInterval;
+        for (uint32_t tap = 0; tap < taps; ++tap)
+        {
+            double inPhase = 0;
+            double quadrature = 0;
+            for (uint32_t n = 0; n < sinusoids; ++n)
+            {
+                size_t i = static_cast<size_t>(tap) * sinusoids + n;
+                inPhase += std::cos(inPhaseFrequencies[i] * time + inPhasePhases[i]);
+                quadrature += std::cos(quadratureFrequencies[i] * time + quadraturePhases[i]);
+            }
+            tapGains[tap] = std::complex<double>(inPhase, quadrature) * scale;
+        }
+        std::fill(rbResponses.begin(), rbResponses.end(), std::complex<double>(0));
+        for (uint32_t tap = 0; tap < taps; ++tap)
+        {
+            for (uint32_t rb = 0; rb < rbNum; ++rb)
+            {
+                rbResponses[rb] += tapGains[tap] * responses[tap * rbNum + rb];
+            }
+        }
+        for (uint32_t rb = 0; rb < rbNum; ++rb)
+        {
+            double gain = std::norm(rbResponses[rb]);
+            gains[static_cast<size_t>(sample) * rbNum + rb] = gain;
+            sum += gain;
+        }
+    }
+
+    // A finite trace of a slow fading has a mean gain a little off one, which would bias the SINR:
+    double mean = sum / gains.size();
+    if (mean > 0)
+    {
+        for (float& gain : gains)
+        {
+            gain /= mean;
+        }
+    }
+    return gains;
+}
+
+/**
+ * The file of the synthetic trace of the given parameters in a cache directory, which is generated if it is not
+ * there yet.
+ */
+inline std::string
+GetGeneratedFadingTrace(const FadingTraceParameters& parameters, const std::string& cacheDirectory)
+{
+    namespace fs = std::filesystem;
+    std::ostringstream name;
+    name << parameters.profile << '-' << parameters.doppler << "Hz-" << parameters.duration << "s-" << std::hex
+         << GetFadingTraceHash(parameters.GetKey()) << ".bin";
+    fs::path file = fs::path(cacheDirectory) / name.str();
+    std::error_code error;
+    if (!fs::exists(file, error))
+    {
+        std::vector<float> gains = GenerateFadingTrace(parameters);
+        fs::create_directories(cacheDirectory);
+        WriteFadingTrace(file.string(),
+                         parameters.rbNum,
+                         gains.size() / parameters.rbNum,
+                         parameters.sampleInterval,
+                         gains,
+                         FADING_TRACE_CONTINUOUS);
+    }
+    return file.string();
+}
+
+} // namespace ns3
+
+#endif /* FADING_GENERATOR_H */
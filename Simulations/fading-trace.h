@@ -0,0 +1,410 @@
+#ifndef FADING_TRACE_H
+#define FADING_TRACE_H
+
+#include "fading-generator.h"
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/spectrum-module.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Fading traces loaded by memory-mapping, instead of the parsing of the text traces of TraceFadingLossModel.
+ *
+ * TraceFadingLossModel parses its .fad file (10^6 values in text) into vectors in every simulation, so every
+ * replication of a sweep pays for it in time, and every worker process in memory. Here, a text trace is converted
+ * once into a binary form, kept in a cache directory (see fading-generator.h): the linear power gains of the
+ * resource blocks, sample by sample, so that the gains of a sample are contiguous and need no conversion from dB.
+ * The binary traces are mapped read-only and shared: by all the simulations of a process, and through the page cache
+ * by all the processes of a machine.
+ *
+ * MappedTraceFadingLossModel applies them like TraceFadingLossModel: every link (a pair of mobility models) plays
+ * its trace from a random position, moved every WindowSize. A continuous trace (a synthetic one) is played from a
+ * single random position per link instead, which leaves room for PlayDuration if the trace is long enough, so that
+ * the link keeps the continuity of the generated fading. Its links can use different traces: the trace of a UE
+ * is a profile (pedestrian, vehicular or urban, the EPA 3 km/h, EVA 60 km/h and ETU 3 km/h traces of ns-3), a
+ * synthetic trace (<EPA|EVA|ETU>:<Doppler in Hz>:<duration in s>, generated into the cache directory by
+ * fading-generator.h), a .fad file or a binary trace, and the links without a UE trace have no fading. The traces
+ * are loaded when they are set, before the simulation runs.
+ */
+
+namespace ns3
+{
+
+/**
+ * The file of a fading trace: the trace of ns-3 of a profile, nothing for "none", or the trace itself.
+ */
+inline std::string
+GetFadingTraceFile(const std::string& trace)
+{
+    static const std::map<std::string, std::string> profiles = {
+        {"pedestrian", "src/lte/model/fading-traces/fading_trace_EPA_3kmph.fad"},
+        {"vehicular", "src/lte/model/fading-traces/fading_trace_EVA_60kmph.fad"},
+        {"urban", "src/lte/model/fading-traces/fading_trace_ETU_3kmph.fad"},
+        {"none", ""}};
+    auto profile = profiles.find(trace);
+    return profile != profiles.end() ? profile->second : trace;
+}
+
+/**
+ * Whether a file is a binary fading trace, rather than a text one.
+ */
+inline bool
+IsBinaryFadingTrace(const std::string& filename)
+{
+    char magic[8] = {};
+    std::ifstream file(filename, std::ios::binary);
+    NS_ABORT_MSG_IF(!file, "Cannot open the fading trace " << filename);
+    file.read(magic, sizeof(magic));
+    return file && std::memcmp(magic, "FADTRACE", sizeof(magic)) == 0;
+}
+
+/**
+ * The binary form of a text trace of TraceFadingLossModel (a line of fading values in dB per resource block, a
+ * value per ms), converted into the cache directory if it is not there yet, or older than the text trace.
+ */
+inline std::string
+ConvertFadingTrace(const std::string& textFile, const std::string& cacheDirectory)
+{
+    namespace fs = std::filesystem;
+    std::error_code error;
+    fs::path text = fs::absolute(textFile, error);
+    NS_ABORT_MSG_IF(error || !fs::exists(text, error), "Cannot open the fading trace " << textFile);
+    std::ostringstream name;
+    name << text.stem().string() << '-' << std::hex << GetFadingTraceHash(text.string()) << ".bin";
+    fs::path binary = fs::path(cacheDirectory) / name.str();
+    std::error_code binaryError;
+    std::error_code textError;
+    if (fs::exists(binary, binaryError) &&
+        fs::last_write_time(binary, binaryError) >= fs::last_write_time(text, textError) && !binaryError && !textError)
+    {
+        return binary.string();
+    }
+
+    std::ifstream file(textFile);
+    NS_ABORT_MSG_IF(!file, "Cannot open the fading trace " << textFile);
+    std::vector<std::vector<float>> rbs; // The values in dB, RB by RB.
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream values(line);
+        std::vector<float> rb{std::istream_iterator<float>(values), std::istream_iterator<float>()};
+        if (rb.empty())
+        {
+            continue;
+        }
+        NS_ABORT_MSG_IF(!rbs.empty() && rb.size() != rbs[0].size(),
+                        "The RBs of the fading trace " << textFile << " have different numbers of samples");
+        rbs.push_back(std::move(rb));
+    }
+    NS_ABORT_MSG_IF(rbs.empty(), "The fading trace " << textFile << " is empty");
+
+    auto rbNum = static_cast<uint32_t>(rbs.size());
+    auto samplesNum = static_cast<uint32_t>(rbs[0].size());
+    std::vector<float> gains(static_cast<size_t>(rbNum) * samplesNum);
+    for (uint32_t rb = 0; rb < rbNum; ++rb)
+    {
+        for (uint32_t sample = 0; sample < samplesNum; ++sample)
+        {
+            gains[static_cast<size_t>(sample) * rbNum + rb] = std::pow(10.0f, rbs[rb][sample] / 10);
+        }
+    }
+    fs::create_directories(cacheDirectory, error);
+    NS_ABORT_MSG_IF(error, "Cannot create the fading cache " << cacheDirectory << ": " << error.message());
+    try
+    {
+        WriteFadingTrace(binary.string(), rbNum, samplesNum, 0.001, gains);
+    }
+    catch (const std::exception& e)
+    {
+        NS_ABORT_MSG("Cannot convert the fading trace " << textFile << ": " << e.what());
+    }
+    return binary.string();
+}
+
+/**
+ * A binary fading trace, mapped read-only.
+ */
+class MappedFadingTrace
+{
+  public:
+    /**
+     * The trace of a binary file, mapped once per process.
+     */
+    static std::shared_ptr<const MappedFadingTrace> Open(const std::string& filename)
+    {
+        static std::map<std::string, std::shared_ptr<const MappedFadingTrace>> traces;
+        std::shared_ptr<const MappedFadingTrace>& trace = traces[filename];
+        if (!trace)
+        {
+            trace.reset(new MappedFadingTrace(filename));
+        }
+        return trace;
+    }
+
+    MappedFadingTrace(const MappedFadingTrace&) = delete;
+    MappedFadingTrace& operator=(const MappedFadingTrace&) = delete;
+
+    ~MappedFadingTrace()
+    {
+        munmap(m_data, m_size);
+    }
+
+    uint32_t GetRbNum() const
+    {
+        return m_header->rbNum;
+    }
+
+    uint32_t GetSamplesNum() const
+    {
+        return m_header->samplesNum;
+    }
+
+    Time GetSampleInterval() const
+    {
+        return Seconds(m_header->sampleInterval);
+    }
+
+    /**
+     * Whether the trace is played continuously, rather than in random windows.
+     */
+    bool IsContinuous() const
+    {
+        return m_header->flags & FADING_TRACE_CONTINUOUS;
+    }
+
+    /**
+     * The linear power gains of the RBs at a sample.
+     */
+    const float* GetGains(uint32_t sample) const
+    {
+        return m_gains + static_cast<size_t>(sample) * m_header->rbNum;
+    }
+
+  private:
+    explicit MappedFadingTrace(const std::string& filename)
+    {
+        int fd = open(filename.c_str(), O_RDONLY);
+        NS_ABORT_MSG_IF(fd < 0, "Cannot open the fading trace " << filename);
+        struct stat status;
+        NS_ABORT_MSG_IF(fstat(fd, &status) != 0, "Cannot stat the fading trace " << filename);
+        m_size = status.st_size;
+        NS_ABORT_MSG_IF(m_size < sizeof(FadingTraceHeader), filename << " is not a fading trace");
+        m_data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        NS_ABORT_MSG_IF(m_data == MAP_FAILED, "Cannot map the fading trace " << filename);
+
+        m_header = static_cast<const FadingTraceHeader*>(m_data);
+        m_gains = reinterpret_cast<const float*>(m_header + 1);
+        NS_ABORT_MSG_IF(std::memcmp(m_header->magic, "FADTRACE", sizeof(m_header->magic)) != 0,
+                        filename << " is not a binary fading trace");
+        NS_ABORT_MSG_IF(m_header->version != FADING_TRACE_VERSION,
+                        "The fading trace " << filename << " has version " << m_header->version << ", not "
+                                            << FADING_TRACE_VERSION);
+        NS_ABORT_MSG_IF(m_header->rbNum == 0 || m_header->samplesNum == 0 || !(m_header->sampleInterval > 0),
+                        "The fading trace " << filename << " is empty");
+        NS_ABORT_MSG_IF(m_size != sizeof(FadingTraceHeader) +
+                                      static_cast<size_t>(m_header->rbNum) * m_header->samplesNum * sizeof(float),
+                        "The fading trace " << filename << " is truncated");
+    }
+
+    void* m_data;
+    size_t m_size;
+    const FadingTraceHeader* m_header;
+    const float* m_gains;
+};
+
+/**
+ * The mapped trace of a profile, a synthetic trace or a text trace (generated or converted into the cache
+ * directory), or a binary trace, or nothing for "none" or an empty trace. A bad trace file aborts, naming the file;
+ * a bad synthetic trace throws the std::invalid_argument of fading-generator.h, which does not depend on ns-3.
+ */
+inline std::shared_ptr<const MappedFadingTrace>
+LoadFadingTrace(const std::string& trace, const std::string& cacheDirectory)
+{
+    FadingTraceParameters parameters;
+    if (ParseFadingTraceSpec(trace, parameters))
+    {
+        return MappedFadingTrace::Open(GetGeneratedFadingTrace(parameters, cacheDirectory));
+    }
+    std::string file = GetFadingTraceFile(trace);
+    if (file.empty())
+    {
+        return nullptr;
+    }
+    return MappedFadingTrace::Open(IsBinaryFadingTrace(file) ? file : ConvertFadingTrace(file, cacheDirectory));
+}
+
+class MappedTraceFadingLossModel : public SpectrumPropagationLossModel
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid =
+            TypeId("ns3::MappedTraceFadingLossModel")
+                .SetParent<SpectrumPropagationLossModel>()
+                .SetGroupName("Lte")
+                .AddConstructor<MappedTraceFadingLossModel>()
+                .AddAttribute("CacheDirectory",
+                              "The directory of the binary forms of the text traces",
+                              StringValue("fading-cache"),
+                              MakeStringAccessor(&MappedTraceFadingLossModel::m_cacheDirectory),
+                              MakeStringChecker())
+                .AddAttribute("WindowSize",
+                              "How long a link plays its trace from a random position before moving to another",
+                              TimeValue(Seconds(0.5)),
+                              MakeTimeAccessor(&MappedTraceFadingLossModel::m_windowSize),
+                              MakeTimeChecker())
+                .AddAttribute("PlayDuration",
+                              "How long the links play a continuous trace: their random start leaves room for it, "
+                              "if the trace is long enough",
+                              TimeValue(Seconds(0)),
+                              MakeTimeAccessor(&MappedTraceFadingLossModel::m_playDuration),
+                              MakeTimeChecker());
+        return tid;
+    }
+
+    MappedTraceFadingLossModel()
+        : m_random(CreateObject<UniformRandomVariable>())
+    {
+    }
+
+    /**
+     * Set the trace of the links of a UE (a profile, or a synthetic, text or binary trace, see LoadFadingTrace),
+     * which is loaded now, from or into the CacheDirectory.
+     */
+    void SetUeTrace(Ptr<const MobilityModel> ue, const std::string& trace)
+    {
+        auto loaded = m_traces.find(trace);
+        if (loaded == m_traces.end())
+        {
+            loaded = m_traces.emplace(trace, LoadFadingTrace(trace, m_cacheDirectory)).first;
+        }
+        m_ueTraces[ue] = loaded->second;
+    }
+
+    /**
+     * Use the given RNG stream, and return the number of streams used.
+     */
+    int64_t AssignStreams(int64_t stream)
+    {
+        m_random->SetStream(stream);
+        return 1;
+    }
+
+  private:
+    struct Link
+    {
+        std::shared_ptr<const MappedFadingTrace> trace; // None without fading.
+        uint32_t offset = 0;                            // The sample at the start of the window.
+        Time windowStart;
+    };
+
+    Ptr<SpectrumValue> DoCalcRxPowerSpectralDensity(Ptr<const SpectrumSignalParameters> params,
+                                                    Ptr<const MobilityModel> a,
+                                                    Ptr<const MobilityModel> b) const override
+    {
+        Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue>(params->psd);
+        Link& link = GetLink(a, b, *rxPsd);
+        if (!link.trace)
+        {
+            return rxPsd;
+        }
+        const MappedFadingTrace& trace = *link.trace;
+        Time now = Simulator::Now();
+        if (!trace.IsContinuous() && now - link.windowStart >= m_windowSize)
+        {
+            link.offset = GetRandomOffset(trace);
+            link.windowStart = now;
+        }
+        uint64_t sample = link.offset + (now - link.windowStart).GetInteger() / trace.GetSampleInterval().GetInteger();
+        const float* gains = trace.GetGains(sample % trace.GetSamplesNum());
+        uint32_t rb = 0;
+        for (auto value = rxPsd->ValuesBegin(); value != rxPsd->ValuesEnd(); ++value, ++rb)
+        {
+            *value *= gains[rb];
+        }
+        return rxPsd;
+    }
+
+    int64_t DoAssignStreams(int64_t stream) override
+    {
+        return AssignStreams(stream);
+    }
+
+    /**
+     * The state of a link, created on its first transmission. The spectrum of a link does not change, so it is
+     * checked against the trace only then.
+     */
+    Link& GetLink(Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, SpectrumValue& psd) const
+    {
+        auto found = m_links.find(std::make_pair(a, b));
+        if (found != m_links.end())
+        {
+            return found->second;
+        }
+        Link& link = m_links[std::make_pair(a, b)];
+        // The trace of the UE of the link, whichever of a (uplink) and b (downlink) it is:
+        auto ue = m_ueTraces.find(a);
+        if (ue == m_ueTraces.end())
+        {
+            ue = m_ueTraces.find(b);
+        }
+        if (ue == m_ueTraces.end() || !ue->second)
+        {
+            return link;
+        }
+        link.trace = ue->second;
+        NS_ABORT_MSG_IF(static_cast<size_t>(std::distance(psd.ValuesBegin(), psd.ValuesEnd())) > link.trace->GetRbNum(),
+                        "The fading trace has fewer RBs (" << link.trace->GetRbNum() << ") than the spectrum");
+        link.offset = GetRandomOffset(*link.trace);
+        link.windowStart = Simulator::Now();
+        return link;
+    }
+
+    /**
+     * A random start of a window, or of the whole play of a continuous trace, such that it fits in the trace if it
+     * can.
+     */
+    uint32_t GetRandomOffset(const MappedFadingTrace& trace) const
+    {
+        Time window = trace.IsContinuous() ? m_playDuration : m_windowSize;
+        auto windowSamples =
+            static_cast<uint32_t>(std::ceil(window.GetSeconds() / trace.GetSampleInterval().GetSeconds()));
+        uint32_t last = windowSamples > 0 && windowSamples < trace.GetSamplesNum()
+                            ? trace.GetSamplesNum() - windowSamples
+                            : trace.GetSamplesNum() - 1;
+        return m_random->GetInteger(0, last);
+    }
+
+    std::string m_cacheDirectory;
+    Time m_windowSize;
+    Time m_playDuration;
+    Ptr<UniformRandomVariable> m_random;
+    std::map<std::string, std::shared_ptr<const MappedFadingTrace>> m_traces; // By name, as given to SetUeTrace.
+    std::map<Ptr<const MobilityModel>, std::shared_ptr<const MappedFadingTrace>> m_ueTraces; // None: no fading.
+    mutable std::map<std::pair<Ptr<const MobilityModel>, Ptr<const MobilityModel>>, Link> m_links;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(MappedTraceFadingLossModel);
+
+} // namespace ns3
+
+#endif /* FADING_TRACE_H */
@@ -0,0 +1,190 @@
+#ifndef KPI_STATISTICS_H
+#define KPI_STATISTICS_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * Incremental mean and variance of a KPI (Welford's algorithm), and the 95% confidence interval of its mean.
+ * Nothing is allocated per sample, so it can be updated from trace sinks.
+ * Also the MSER truncation point of a time series, which locates the end of its initial transient,
+ * and the batch means confidence interval of the mean of its (autocorrelated) steady state, and Jain's
+ * fairness index of a set of throughputs.
+ */
+
+namespace ns3
+{
+
+/**
+ * The two-sided 95% quantile of Student's t distribution with the given degrees of freedom.
+ */
+inline double
+StudentT95(uint64_t degreesOfFreedom)
+{
+    static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                   2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                   2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (degreesOfFreedom == 0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    if (degreesOfFreedom <= sizeof(table) / sizeof(table[0]))
+    {
+        return table[degreesOfFreedom - 1];
+    }
+    return 1.96;
+}
+
+class RunningStatistics
+{
+  public:
+    void Add(double value)
+    {
+        ++m_count;
+        double delta = value - m_mean;
+        m_mean += delta / m_count;
+        m_m2 += delta * (value - m_mean);
+    }
+
+    void Reset()
+    {
+        m_count = 0;
+        m_mean = 0;
+        m_m2 = 0;
+    }
+
+    uint64_t GetCount() const
+    {
+        return m_count;
+    }
+
+    double GetMean() const
+    {
+        return m_mean;
+    }
+
+    /**
+     * The sample standard deviation (zero for less than two samples).
+     */
+    double GetStdDev() const
+    {
+        return m_count > 1 ? std::sqrt(m_m2 / (m_count - 1)) : 0;
+    }
+
+    /**
+     * The half-width of the 95% confidence interval of the mean (infinite for less than two samples).
+     */
+    double GetConfidenceInterval95() const
+    {
+        if (m_count < 2)
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+        return StudentT95(m_count - 1) * GetStdDev() / std::sqrt(static_cast<double>(m_count));
+    }
+
+  private:
+    uint64_t m_count = 0;
+    double m_mean = 0;
+    double m_m2 = 0; // Sum of the squared differences from the mean.
+};
+
+/**
+ * The MSER (Marginal Standard Error Rule) truncation point of a time series: the number of initial samples d
+ * that minimizes the squared standard error of the mean of the remaining samples,
+ *
+ *   sum((x[i] - mean(x[d..n)))^2 for i in [d, n)) / (n - d)^2
+ *
+ * d is searched in the first half of the series only, where MSER is stable. The samples after d are
+ * the steady state of the series.
+ */
+inline size_t
+MserTruncationPoint(const std::vector<double>& samples)
+{
+    size_t n = samples.size();
+    if (n < 2)
+    {
+        return 0;
+    }
+    // The sums of the samples and of their squares from i to the end:
+    std::vector<double> sum(n + 1, 0);
+    std::vector<double> sumOfSquares(n + 1, 0);
+    for (size_t i = n; i-- > 0;)
+    {
+        sum[i] = sum[i + 1] + samples[i];
+        sumOfSquares[i] = sumOfSquares[i + 1] + samples[i] * samples[i];
+    }
+    size_t truncation = 0;
+    double minimum = std::numeric_limits<double>::infinity();
+    for (size_t d = 0; d <= n / 2; ++d)
+    {
+        double remaining = n - d;
+        double squaredErrors = sumOfSquares[d] - sum[d] * sum[d] / remaining;
+        double mser = squaredErrors / (remaining * remaining);
+        if (mser < minimum)
+        {
+            minimum = mser;
+            truncation = d;
+        }
+    }
+    return truncation;
+}
+
+/**
+ * The half-width of the 95% confidence interval of the mean of the samples from 'first' on, by the method of
+ * batch means: the samples are split into consecutive batches, whose means are close to independent even when
+ * the samples are not. The samples that do not fill a batch are left out at the start. Infinite if there are
+ * fewer samples than batches.
+ */
+inline double
+BatchMeansConfidenceInterval95(const std::vector<double>& samples, size_t first, size_t batches = 10)
+{
+    if (first >= samples.size() || samples.size() - first < batches || batches < 2)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    size_t batchSize = (samples.size() - first) / batches;
+    size_t start = samples.size() - batchSize * batches;
+    RunningStatistics batchMeans;
+    for (size_t batch = 0; batch < batches; ++batch)
+    {
+        double sum = 0;
+        for (size_t i = 0; i < batchSize; ++i)
+        {
+            sum += samples[start + batch * batchSize + i];
+        }
+        batchMeans.Add(sum / batchSize);
+    }
+    return batchMeans.GetConfidenceInterval95();
+}
+
+/**
+ * Jain's fairness index of a set of throughputs: (sum x)^2 / (n * sum x^2). It is 1 when all the throughputs
+ * are equal, and 1/n when a single flow gets everything. NaN for an empty set; 1 if all the throughputs are zero.
+ */
+inline double
+JainFairnessIndex(const std::vector<double>& throughputs)
+{
+    if (throughputs.empty())
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    double sum = 0;
+    double sumOfSquares = 0;
+    for (double throughput : throughputs)
+    {
+        sum += throughput;
+        sumOfSquares += throughput * throughput;
+    }
+    if (sumOfSquares == 0)
+    {
+        return 1;
+    }
+    return sum * sum / (throughputs.size() * sumOfSquares);
+}
+
+} // namespace ns3
+
+#endif /* KPI_STATISTICS_H */
@@ -0,0 +1,497 @@
+#ifndef KPI_TABLE_H
+#define KPI_TABLE_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * A compact, columnar table of per-run KPIs, and its binary file format.
+ *
+ * A file is a sequence of self-contained row groups, so a process appends its runs to a file with a single
+ * write, and the files of parallel jobs are merged by concatenating them. In a row group every column
+ * is stored contiguously, and every column starts 8-byte aligned:
+ *
+ *   RowGroup := "KPIGROUP" | uint32 version | uint32 rows | uint32 columns | uint32 size of the group | Column...
+ *   Column   := uint16 name length | name | uint8 type | uint8 role | padding to 8 bytes | data | padding to 8 bytes
+ *   data     := int64[rows]                                                        (type 0, missing: INT64_MIN)
+ *             | double[rows]                                                       (type 1, missing: NaN)
+ *             | uint32 dictionary size | (uint16 length | bytes)... | padding to 4 bytes
+ *               | uint32[rows] indices into the dictionary                         (type 2, missing: "")
+ *
+ * All the integers are little-endian. The role of a column tells the reader how to summarize it:
+ * the runs are grouped by their PARAMETER columns, ID columns (seed, run, ...) identify a run,
+ * and the KPI columns are aggregated.
+ *
+ * ReadFrom maps the file and decodes the columns straight from the mapping, without reading it into memory first.
+ * This header does not depend on ns-3, so that tools can read the tables without linking ns-3.
+ */
+
+namespace ns3
+{
+
+enum class KpiColumnType : uint8_t
+{
+    INT64 = 0,
+    DOUBLE = 1,
+    STRING = 2
+};
+
+enum class KpiColumnRole : uint8_t
+{
+    PARAMETER = 0,
+    ID = 1,
+    KPI = 2
+};
+
+struct KpiColumn
+{
+    std::string name;
+    KpiColumnType type;
+    KpiColumnRole role;
+    std::vector<int64_t> ints;
+    std::vector<double> doubles;
+    std::vector<std::string> strings;
+
+    static constexpr int64_t MISSING_INT = std::numeric_limits<int64_t>::min();
+
+    size_t GetSize() const
+    {
+        switch (type)
+        {
+        case KpiColumnType::INT64:
+            return ints.size();
+        case KpiColumnType::DOUBLE:
+            return doubles.size();
+        default:
+            return strings.size();
+        }
+    }
+
+    bool IsMissing(size_t row) const
+    {
+        switch (type)
+        {
+        case KpiColumnType::INT64:
+            return ints[row] == MISSING_INT;
+        case KpiColumnType::DOUBLE:
+            return std::isnan(doubles[row]);
+        default:
+            return strings[row].empty();
+        }
+    }
+
+    /**
+     * The value of a numeric column as a double (NaN if missing or not numeric).
+     */
+    double GetDouble(size_t row) const
+    {
+        if (IsMissing(row) || type == KpiColumnType::STRING)
+        {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return type == KpiColumnType::INT64 ? static_cast<double>(ints[row]) : doubles[row];
+    }
+
+    std::string ToString(size_t row) const
+    {
+        if (IsMissing(row))
+        {
+            return "";
+        }
+        if (type == KpiColumnType::STRING)
+        {
+            return strings[row];
+        }
+        std::ostringstream value;
+        if (type == KpiColumnType::INT64)
+        {
+            value << ints[row];
+        }
+        else
+        {
+            value.precision(std::numeric_limits<double>::max_digits10);
+            value << doubles[row];
+        }
+        return value.str();
+    }
+
+    void AddMissing()
+    {
+        switch (type)
+        {
+        case KpiColumnType::INT64:
+            ints.push_back(MISSING_INT);
+            break;
+        case KpiColumnType::DOUBLE:
+            doubles.push_back(std::numeric_limits<double>::quiet_NaN());
+            break;
+        default:
+            strings.emplace_back();
+        }
+    }
+};
+
+class KpiTable
+{
+  public:
+    /**
+     * Add a row where all the columns are missing, and return its index.
+     */
+    size_t AddRow()
+    {
+        for (KpiColumn& column : m_columns)
+        {
+            column.AddMissing();
+        }
+        return m_rows++;
+    }
+
+    void Set(size_t row, const std::string& name, KpiColumnRole role, int64_t value)
+    {
+        GetColumn(name, KpiColumnType::INT64, role).ints[row] = value;
+    }
+
+    void Set(size_t row, const std::string& name, KpiColumnRole role, double value)
+    {
+        GetColumn(name, KpiColumnType::DOUBLE, role).doubles[row] = value;
+    }
+
+    void Set(size_t row, const std::string& name, KpiColumnRole role, const std::string& value)
+    {
+        GetColumn(name, KpiColumnType::STRING, role).strings[row] = value;
+    }
+
+    size_t GetRows() const
+    {
+        return m_rows;
+    }
+
+    const std::vector<KpiColumn>& GetColumns() const
+    {
+        return m_columns;
+    }
+
+    const KpiColumn* FindColumn(const std::string& name) const
+    {
+        for (const KpiColumn& column : m_columns)
+        {
+            if (column.name == name)
+            {
+                return &column;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Append the rows of another table, adding the columns this table does not have yet.
+     */
+    void Merge(const KpiTable& other)
+    {
+        for (size_t row = 0; row < other.m_rows; ++row)
+        {
+            size_t newRow = AddRow();
+            for (const KpiColumn& column : other.m_columns)
+            {
+                if (column.IsMissing(row))
+                {
+                    continue;
+                }
+                switch (column.type)
+                {
+                case KpiColumnType::INT64:
+                    Set(newRow, column.name, column.role, column.ints[row]);
+                    break;
+                case KpiColumnType::DOUBLE:
+                    Set(newRow, column.name, column.role, column.doubles[row]);
+                    break;
+                default:
+                    Set(newRow, column.name, column.role, column.strings[row]);
+                }
+            }
+        }
+    }
+
+    /**
+     * Append the table to a file as one row group, with a single write.
+     */
+    void AppendTo(const std::string& filename) const
+    {
+        std::string group = Serialize();
+        std::ofstream file(filename, std::ios::binary | std::ios::app);
+        if (!file.write(group.data(), group.size()))
+        {
+            throw std::runtime_error("Cannot append to the KPI table " + filename);
+        }
+    }
+
+    /**
+     * Read all the row groups of a file into one table.
+     */
+    static KpiTable ReadFrom(const std::string& filename)
+    {
+        // The file is mapped, and the columns are decoded straight from the mapping:
+        struct Mapping
+        {
+            void* data = nullptr;
+            size_t size = 0;
+
+            ~Mapping()
+            {
+                if (data != nullptr)
+                {
+                    munmap(data, size);
+                }
+            }
+        } mapping;
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Cannot open the KPI table " + filename);
+        }
+        struct stat status;
+        if (fstat(fd, &status) != 0)
+        {
+            close(fd);
+            throw std::runtime_error("Cannot stat the KPI table " + filename);
+        }
+        mapping.size = status.st_size;
+        if (mapping.size > 0)
+        {
+            void* data = mmap(nullptr, mapping.size, PROT_READ, MAP_PRIVATE, fd, 0);
+            mapping.data = data != MAP_FAILED ? data : nullptr;
+        }
+        close(fd);
+        if (mapping.size > 0 && mapping.data == nullptr)
+        {
+            throw std::runtime_error("Cannot map the KPI table " + filename);
+        }
+        std::string_view content(static_cast<const char*>(mapping.data), mapping.size);
+
+        KpiTable table;
+        size_t offset = 0;
+        while (offset < content.size())
+        {
+            offset = table.DeserializeGroup(content, offset, filename);
+        }
+        return table;
+    }
+
+  private:
+    static constexpr char MAGIC[] = "KPIGROUP";
+    static constexpr uint32_t VERSION = 1;
+
+    KpiColumn& GetColumn(const std::string& name, KpiColumnType type, KpiColumnRole role)
+    {
+        for (KpiColumn& column : m_columns)
+        {
+            if (column.name == name)
+            {
+                if (column.type != type)
+                {
+                    throw std::runtime_error("The KPI column " + name + " is set with different types");
+                }
+                return column;
+            }
+        }
+        KpiColumn column{name, type, role, {}, {}, {}};
+        for (size_t row = 0; row < m_rows; ++row)
+        {
+            column.AddMissing();
+        }
+        m_columns.push_back(std::move(column));
+        return m_columns.back();
+    }
+
+    template <class T>
+    static void Put(std::string& buffer, T value)
+    {
+        // The supported platforms are little-endian, so the native layout is the file layout.
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    static void Pad(std::string& buffer, size_t alignment)
+    {
+        buffer.append((alignment - buffer.size() % alignment) % alignment, '\0');
+    }
+
+    std::string Serialize() const
+    {
+        std::string group(MAGIC, 8);
+        Put<uint32_t>(group, VERSION);
+        Put<uint32_t>(group, m_rows);
+        Put<uint32_t>(group, m_columns.size());
+        size_t sizeOffset = group.size();
+        Put<uint32_t>(group, 0); // The size of the group, filled in below.
+        for (const KpiColumn& column : m_columns)
+        {
+            Put<uint16_t>(group, column.name.size());
+            group += column.name;
+            Put<uint8_t>(group, static_cast<uint8_t>(column.type));
+            Put<uint8_t>(group, static_cast<uint8_t>(column.role));
+            Pad(group, 8);
+            switch (column.type)
+            {
+            case KpiColumnType::INT64:
+                group.append(reinterpret_cast<const char*>(column.ints.data()), m_rows * sizeof(int64_t));
+                break;
+            case KpiColumnType::DOUBLE:
+                group.append(reinterpret_cast<const char*>(column.doubles.data()), m_rows * sizeof(double));
+                break;
+            default: {
+                std::map<std::string, uint32_t> dictionary;
+                std::vector<const std::string*> entries;
+                std::vector<uint32_t> indices;
+                for (const std::string& value : column.strings)
+                {
+                    auto [it, inserted] = dictionary.emplace(value, entries.size());
+                    if (inserted)
+                    {
+                        entries.push_back(&it->first);
+                    }
+                    indices.push_back(it->second);
+                }
+                Put<uint32_t>(group, entries.size());
+                for (const std::string* entry : entries)
+                {
+                    Put<uint16_t>(group, entry->size());
+                    group += *entry;
+                }
+                Pad(group, 4);
+                group.append(reinterpret_cast<const char*>(indices.data()), m_rows * sizeof(uint32_t));
+            }
+            }
+            Pad(group, 8);
+        }
+        uint32_t size = group.size();
+        std::memcpy(&group[sizeOffset], &size, sizeof(size));
+        return group;
+    }
+
+    template <class T>
+    static T Get(std::string_view content, size_t& offset, size_t end, const std::string& filename)
+    {
+        if (offset + sizeof(T) > end)
+        {
+            throw std::runtime_error("Truncated KPI table " + filename);
+        }
+        T value;
+        std::memcpy(&value, content.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    static std::string GetString(std::string_view content, size_t& offset, size_t end, const std::string& filename)
+    {
+        uint16_t length = Get<uint16_t>(content, offset, end, filename);
+        if (offset + length > end)
+        {
+            throw std::runtime_error("Truncated KPI table " + filename);
+        }
+        std::string value(content.substr(offset, length));
+        offset += length;
+        return value;
+    }
+
+    static void Skip(size_t& offset, size_t groupStart, size_t alignment)
+    {
+        offset += (alignment - (offset - groupStart) % alignment) % alignment;
+    }
+
+    /**
+     * Read the row group at the offset into this table, and return the offset of the next one.
+     */
+    size_t DeserializeGroup(std::string_view content, size_t offset, const std::string& filename)
+    {
+        size_t start = offset;
+        if (content.compare(offset, 8, MAGIC, 8) != 0)
+        {
+            throw std::runtime_error("Not a KPI table (or a corrupted one): " + filename);
+        }
+        offset += 8;
+        size_t end = content.size();
+        if (Get<uint32_t>(content, offset, end, filename) != VERSION)
+        {
+            throw std::runtime_error("Unsupported KPI table version in " + filename);
+        }
+        uint32_t rows = Get<uint32_t>(content, offset, end, filename);
+        uint32_t columns = Get<uint32_t>(content, offset, end, filename);
+        end = start + Get<uint32_t>(content, offset, end, filename);
+        if (end > content.size())
+        {
+            throw std::runtime_error("Truncated KPI table " + filename);
+        }
+
+        KpiTable group;
+        for (uint32_t i = 0; i < rows; ++i)
+        {
+            group.AddRow();
+        }
+        for (uint32_t c = 0; c < columns; ++c)
+        {
+            std::string name = GetString(content, offset, end, filename);
+            auto type = static_cast<KpiColumnType>(Get<uint8_t>(content, offset, end, filename));
+            auto role = static_cast<KpiColumnRole>(Get<uint8_t>(content, offset, end, filename));
+            Skip(offset, start, 8);
+            KpiColumn& column = group.GetColumn(name, type, role);
+            switch (type)
+            {
+            case KpiColumnType::INT64:
+                for (uint32_t row = 0; row < rows; ++row)
+                {
+                    column.ints[row] = Get<int64_t>(content, offset, end, filename);
+                }
+                break;
+            case KpiColumnType::DOUBLE:
+                for (uint32_t row = 0; row < rows; ++row)
+                {
+                    column.doubles[row] = Get<double>(content, offset, end, filename);
+                }
+                break;
+            case KpiColumnType::STRING: {
+                std::vector<std::string> dictionary(Get<uint32_t>(content, offset, end, filename));
+                for (std::string& entry : dictionary)
+                {
+                    entry = GetString(content, offset, end, filename);
+                }
+                Skip(offset, start, 4);
+                for (uint32_t row = 0; row < rows; ++row)
+                {
+                    uint32_t index = Get<uint32_t>(content, offset, end, filename);
+                    if (index >= dictionary.size())
+                    {
+                        throw std::runtime_error("Corrupted KPI table " + filename);
+                    }
+                    column.strings[row] = dictionary[index];
+                }
+                break;
+            }
+            default:
+                throw std::runtime_error("Unknown column type in KPI table " + filename);
+            }
+            Skip(offset, start, 8);
+        }
+        Merge(group);
+        return end;
+    }
+
+    size_t m_rows = 0;
+    std::vector<KpiColumn> m_columns;
+};
+
+} // namespace ns3
+
+#endif /* KPI_TABLE_H */
@@ -0,0 +1,133 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * A streaming histogram of latencies with a bounded relative error, in the style of HdrHistogram: the values
+ * below 2 * SUB_BUCKETS have a bucket each, and every power of two above them is split into SUB_BUCKETS
+ * buckets of equal width. A bucket is then narrower than 1/SUB_BUCKETS (1.6%) of its values, at any scale.
+ *
+ * Its memory is fixed (MAX_SHIFT + 2 rows of SUB_BUCKETS counters, 17 KB), whatever the number of samples, and
+ * adding a sample is a few shifts and an increment, so it can be updated per packet from trace sinks over long
+ * runs. The values above its range (2^(MAX_SHIFT + 7) units) are counted in its last bucket.
+ */
+
+namespace ns3
+{
+
+class LatencyHistogram
+{
+  public:
+    static constexpr uint32_t SUB_BUCKET_BITS = 6;
+    static constexpr uint32_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS; // Per power of two: a relative error below 1/64.
+    static constexpr uint32_t MAX_SHIFT = 32;
+
+    LatencyHistogram()
+        : m_counts((MAX_SHIFT + 2) * SUB_BUCKETS, 0)
+    {
+    }
+
+    void Add(uint64_t value)
+    {
+        ++m_counts[GetIndex(value)];
+        ++m_count;
+        m_sum += value;
+        m_min = value < m_min ? value : m_min;
+        m_max = value > m_max ? value : m_max;
+    }
+
+    uint64_t GetCount() const
+    {
+        return m_count;
+    }
+
+    double GetMean() const
+    {
+        return m_count > 0 ? static_cast<double>(m_sum) / m_count : 0;
+    }
+
+    uint64_t GetMin() const
+    {
+        return m_count > 0 ? m_min : 0;
+    }
+
+    uint64_t GetMax() const
+    {
+        return m_max;
+    }
+
+    /**
+     * The value at the given percentile (0 to 100): the middle of the bucket of the sample of that rank,
+     * within the exact minimum and maximum (zero without samples).
+     */
+    double GetPercentile(double percentile) const
+    {
+        if (m_count == 0)
+        {
+            return 0;
+        }
+        auto rank = static_cast<uint64_t>(std::ceil(percentile / 100 * m_count));
+        rank = rank < 1 ? 1 : (rank > m_count ? m_count : rank);
+        uint64_t seen = 0;
+        for (uint32_t index = 0; index < m_counts.size(); ++index)
+        {
+            seen += m_counts[index];
+            if (seen >= rank)
+            {
+                if (index == m_counts.size() - 1)
+                {
+                    return m_max; // The last bucket also counts the values above the range.
+                }
+                uint32_t shift = index < 2 * SUB_BUCKETS ? 0 : index / SUB_BUCKETS - 1;
+                uint64_t low = index < 2 * SUB_BUCKETS ? index : uint64_t(index % SUB_BUCKETS + SUB_BUCKETS) << shift;
+                double middle = low + ((uint64_t(1) << shift) - 1) / 2.0;
+                return middle < m_min ? m_min : (middle > m_max ? m_max : middle);
+            }
+        }
+        return m_max;
+    }
+
+    void Reset()
+    {
+        std::fill(m_counts.begin(), m_counts.end(), 0);
+        m_count = 0;
+        m_sum = 0;
+        m_min = std::numeric_limits<uint64_t>::max();
+        m_max = 0;
+    }
+
+  private:
+    /**
+     * Row 0 and 1 are the values below 2 * SUB_BUCKETS, one per bucket. Row r > 1 is [SUB_BUCKETS, 2 * SUB_BUCKETS)
+     * shifted left by r - 1, in buckets of 2^(r - 1).
+     */
+    static uint32_t GetIndex(uint64_t value)
+    {
+        if (value < 2 * SUB_BUCKETS)
+        {
+            return value;
+        }
+        // value >> shift is in [SUB_BUCKETS, 2 * SUB_BUCKETS):
+        uint32_t shift = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+        if (shift > MAX_SHIFT)
+        {
+            return (MAX_SHIFT + 2) * SUB_BUCKETS - 1;
+        }
+        return (shift + 1) * SUB_BUCKETS + (value >> shift) - SUB_BUCKETS;
+    }
+
+    std::vector<uint64_t> m_counts;
+    uint64_t m_count = 0;
+    uint64_t m_sum = 0;
+    uint64_t m_min = std::numeric_limits<uint64_t>::max();
+    uint64_t m_max = 0;
+};
+
+} // namespace ns3
+
+#endif /* LATENCY_HISTOGRAM_H */
@@ -0,0 +1,204 @@
+#ifndef LOSS_MODELS_H
+#define LOSS_MODELS_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Packet loss models of the Internet links, besides the i.i.d. RateErrorModel of the article:
+ *
+ * - GilbertElliottErrorModel: bursty loss. The link alternates between a good and a bad state (a Markov chain
+ *   stepped once per packet), and drops packets at a different rate in each. GetGilbertElliottTransitions() gives
+ *   the transition probabilities of a mean loss rate and a mean burst length.
+ * - TraceErrorModel: replays a loss trace, one character per packet: '1' is lost, '0' is received (whitespace
+ *   and the lines starting with '#' are skipped). The trace is read once per file, and cycled.
+ */
+
+namespace ns3
+{
+
+class GilbertElliottErrorModel : public ErrorModel
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid =
+            TypeId("ns3::GilbertElliottErrorModel")
+                .SetParent<ErrorModel>()
+                .SetGroupName("Network")
+                .AddConstructor<GilbertElliottErrorModel>()
+                .AddAttribute("GoodToBad",
+                              "The probability of going from the good to the bad state, per packet",
+                              DoubleValue(0.0),
+                              MakeDoubleAccessor(&GilbertElliottErrorModel::m_goodToBad),
+                              MakeDoubleChecker<double>(0, 1))
+                .AddAttribute("BadToGood",
+                              "The probability of going from the bad to the good state, per packet",
+                              DoubleValue(1.0),
+                              MakeDoubleAccessor(&GilbertElliottErrorModel::m_badToGood),
+                              MakeDoubleChecker<double>(0, 1))
+                .AddAttribute("GoodLossRate",
+                              "The loss probability of a packet in the good state",
+                              DoubleValue(0.0),
+                              MakeDoubleAccessor(&GilbertElliottErrorModel::m_goodLossRate),
+                              MakeDoubleChecker<double>(0, 1))
+                .AddAttribute("BadLossRate",
+                              "The loss probability of a packet in the bad state",
+                              DoubleValue(1.0),
+                              MakeDoubleAccessor(&GilbertElliottErrorModel::m_badLossRate),
+                              MakeDoubleChecker<double>(0, 1));
+        return tid;
+    }
+
+    GilbertElliottErrorModel()
+        : m_random(CreateObject<UniformRandomVariable>())
+    {
+    }
+
+    /**
+     * Use the given RNG stream, and return the number of streams used.
+     */
+    int64_t AssignStreams(int64_t stream)
+    {
+        m_random->SetStream(stream);
+        return 1;
+    }
+
+  private:
+    bool DoCorrupt(Ptr<Packet>) override
+    {
+        if (m_bad ? m_random->GetValue() < m_badToGood : m_random->GetValue() < m_goodToBad)
+        {
+            m_bad = !m_bad;
+        }
+        return m_random->GetValue() < (m_bad ? m_badLossRate : m_goodLossRate);
+    }
+
+    void DoReset() override
+    {
+        m_bad = false;
+    }
+
+    Ptr<UniformRandomVariable> m_random;
+    double m_goodToBad;
+    double m_badToGood;
+    double m_goodLossRate;
+    double m_badLossRate;
+    bool m_bad = false;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(GilbertElliottErrorModel);
+
+/**
+ * The GoodToBad and BadToGood probabilities of a GilbertElliottErrorModel that loses every packet in the bad state
+ * and none in the good one, with the given mean loss rate and mean burst length (in packets, at least 1).
+ */
+inline std::pair<double, double>
+GetGilbertElliottTransitions(double lossRate, double burstLength)
+{
+    NS_ABORT_MSG_IF(lossRate < 0 || lossRate >= 1, "The loss rate must be in [0, 1)");
+    NS_ABORT_MSG_IF(burstLength < 1, "The mean burst length must be at least one packet");
+    // The bursts are geometric with mean 1 / badToGood, and the stationary probability of the bad state is
+    // goodToBad / (goodToBad + badToGood), which is the loss rate:
+    double badToGood = 1 / burstLength;
+    double goodToBad = lossRate * badToGood / (1 - lossRate);
+    NS_ABORT_MSG_IF(goodToBad > 1, "A loss rate of " << lossRate << " needs bursts longer than " << burstLength);
+    return {goodToBad, badToGood};
+}
+
+class TraceErrorModel : public ErrorModel
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::TraceErrorModel")
+                                .SetParent<ErrorModel>()
+                                .SetGroupName("Network")
+                                .AddConstructor<TraceErrorModel>()
+                                .AddAttribute("TraceFile",
+                                              "The loss trace: a '1' (lost) or '0' (received) per packet",
+                                              StringValue(""),
+                                              MakeStringAccessor(&TraceErrorModel::m_traceFile),
+                                              MakeStringChecker())
+                                .AddAttribute("Offset",
+                                              "The position in the trace of the first packet",
+                                              UintegerValue(0),
+                                              MakeUintegerAccessor(&TraceErrorModel::m_offset),
+                                              MakeUintegerChecker<uint64_t>());
+        return tid;
+    }
+
+  private:
+    /**
+     * The traces read so far, by file: the instances of the links share them. The cache is not bounded: it keeps
+     * one entry (a bool per sample) per distinct trace file for the life of the process, which the few
+     * traces of a run afford.
+     */
+    static std::shared_ptr<const std::vector<bool>> LoadTrace(const std::string& filename)
+    {
+        static std::map<std::string, std::shared_ptr<const std::vector<bool>>> traces;
+        std::shared_ptr<const std::vector<bool>>& trace = traces[filename];
+        if (!trace)
+        {
+            std::ifstream file(filename);
+            NS_ABORT_MSG_IF(!file, "Cannot open the loss trace " << filename);
+            auto losses = std::make_shared<std::vector<bool>>();
+            std::string line;
+            while (std::getline(file, line))
+            {
+                if (!line.empty() && line[0] == '#')
+                {
+                    continue;
+                }
+                for (char c : line)
+                {
+                    NS_ABORT_MSG_IF(c != '0' && c != '1' && !std::isspace(static_cast<unsigned char>(c)),
+                                    "Invalid character '" << c << "' in the loss trace " << filename);
+                    if (c == '0' || c == '1')
+                    {
+                        losses->push_back(c == '1');
+                    }
+                }
+            }
+            NS_ABORT_MSG_IF(losses->empty(), "The loss trace " << filename << " is empty");
+            trace = losses;
+        }
+        return trace;
+    }
+
+    bool DoCorrupt(Ptr<Packet>) override
+    {
+        if (!m_trace)
+        {
+            m_trace = LoadTrace(m_traceFile);
+            m_position = m_offset % m_trace->size();
+        }
+        bool lost = (*m_trace)[m_position];
+        m_position = (m_position + 1) % m_trace->size();
+        return lost;
+    }
+
+    void DoReset() override
+    {
+        m_position = m_trace ? m_offset % m_trace->size() : 0;
+    }
+
+    std::string m_traceFile;
+    uint64_t m_offset;
+    std::shared_ptr<const std::vector<bool>> m_trace;
+    uint64_t m_position = 0;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(TraceErrorModel);
+
+} // namespace ns3
+
+#endif /* LOSS_MODELS_H */
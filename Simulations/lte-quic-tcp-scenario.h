@@ -0,0 +1,1619 @@
+#ifndef LTE_QUIC_TCP_SCENARIO_H
+#define LTE_QUIC_TCP_SCENARIO_H
+
+#include "ns3/applications-module.h"
+#include "ns3/config-store-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/lte-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/error-model.h"
+#include "ns3/quic-module.h"
+#ifdef NS3_MPI
+#include "ns3/mpi-module.h"
+#endif
+
+#include "fading-trace.h"
+#include "kpi-table.h"
+#include "latency-histogram.h"
+#include "loss-models.h"
+#include "lte-trace-sink.h"
+#include "quic-stream-application.h"
+#include "sender-probe.h"
+#include "simulation-profile.h"
+#include "throughput-sampler.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * The LTE+EPC topology shared by all the programs in Simulations/:
+ *
+ *   remoteHost(s) ---(1Gbps, 12ms, 0.5% loss)--- PGW === EPC === eNB(s) ))) UE(s)
+ *
+ * Every remote host gets its own point-to-point link to the PGW and its own /8 subnet (1.0.0.0, 2.0.0.0, ...).
+ * By default every UE is attached to a single eNB placed at the origin. With several eNBs (see GetHexGridPositions),
+ * the eNBs are connected by X2, the UEs attach to the best cell and are handed over as they move.
+ * A program describes what it needs in an LteQuicTcpScenarioConfig (hosts, UEs, flows) and the LteQuicTcpScenario
+ * builds it.
+ *
+ * In a distributed simulation (ns-3 built with MPI, --distributed, see replication-runner.h), rank 0 simulates
+ * the RAN and the EPC, and the remote hosts are spread over the other ranks: the Internet links, with their 12ms
+ * delay, are the lookahead between the ranks. Every rank creates all the nodes, in the same order, but only
+ * installs the devices and the applications of its own.
+ */
+
+namespace ns3
+{
+
+/**
+ * The transport protocol stack of a node, and the socket factory used by a flow.
+ */
+enum class TransportProtocol
+{
+    TCP,
+    QUIC
+};
+
+inline std::string
+GetSocketFactoryName(TransportProtocol protocol)
+{
+    return protocol == TransportProtocol::QUIC ? "ns3::QuicSocketFactory" : "ns3::TcpSocketFactory";
+}
+
+/**
+ * The TypeId of a congestion control of a protocol: a TcpCongestionOps TypeId name, or the short name of one
+ * (NewReno, Cubic, Bbr, ...: ns3::Tcp<name>). For QUIC, the variants of the QUIC module come first: NewReno is
+ * ns3::QuicCongestionOps, and <name> is ns3::Quic<name> if it exists (the TCP ones run in its legacy mode).
+ */
+inline TypeId
+GetCongestionControlTypeId(TransportProtocol protocol, const std::string& name)
+{
+    std::vector<std::string> candidates = {name};
+    if (name.find("::") == std::string::npos)
+    {
+        candidates = {"ns3::Tcp" + name};
+        if (protocol == TransportProtocol::QUIC)
+        {
+            candidates.insert(candidates.begin(),
+                              name == "NewReno" ? "ns3::QuicCongestionOps" : "ns3::Quic" + name);
+        }
+    }
+    TypeId tid;
+    for (const std::string& candidate : candidates)
+    {
+        if (TypeId::LookupByNameFailSafe(candidate, &tid) && tid.IsChildOf(TcpCongestionOps::GetTypeId()))
+        {
+            return tid;
+        }
+    }
+    NS_ABORT_MSG("Unknown congestion control " << name);
+    return tid;
+}
+
+/**
+ * The default value of an unsigned integer attribute (as changed by Config::SetDefault).
+ */
+inline uint64_t
+GetDefaultUinteger(const std::string& typeName, const std::string& attribute)
+{
+    TypeId::AttributeInformation info;
+    NS_ABORT_MSG_IF(!TypeId::LookupByName(typeName).LookupAttributeByName(attribute, &info),
+                    "No attribute " << typeName << "::" << attribute);
+    return DynamicCast<const UintegerValue>(info.initialValue)->Get();
+}
+
+/**
+ * The number of ranks of the simulation: 1 unless it is distributed.
+ */
+inline uint32_t
+GetSimulationRanks()
+{
+#ifdef NS3_MPI
+    return MpiInterface::IsEnabled() ? MpiInterface::GetSize() : 1;
+#else
+    return 1;
+#endif
+}
+
+inline std::string
+GetProtocolName(TransportProtocol protocol)
+{
+    return protocol == TransportProtocol::QUIC ? "QUIC" : "TCP";
+}
+
+/**
+ * A UE of the scenario. The QUIC stack includes the TCP/IP one, so a QUIC UE can also receive TCP flows.
+ */
+struct ScenarioUe
+{
+    TransportProtocol protocol;   // The stack installed on the UE.
+    Vector position;              // The position of the UE (the eNB is at the origin).
+    double speed = 0;             // If positive, the UE moves by random waypoint in the mobility area, at this
+                                  // speed in m/s, from a random position of it (the position is then ignored).
+    std::string fadingTrace = ""; // The fading trace of its links, if not the one of the config (fading-trace.h).
+};
+
+/**
+ * A handover of a UE between two cells.
+ */
+struct ScenarioHandover
+{
+    uint32_t ue;         // Index in LteQuicTcpScenarioConfig::ues.
+    uint16_t sourceCell; // The cell IDs.
+    uint16_t targetCell;
+    double startTime;    // In seconds.
+    double endTime;      // In seconds (negative if it did not complete).
+};
+
+/**
+ * The positions of the given number of eNBs on a hexagonal grid centered on the origin: the center, then the
+ * rings of 6, 12, ... sites around it.
+ */
+inline std::vector<Vector>
+GetHexGridPositions(uint32_t count, double interSiteDistance)
+{
+    // Axial coordinates (q, r) of the hexagons, walked ring by ring from the center:
+    static const int directions[6][2] = {{1, 0}, {1, -1}, {0, -1}, {-1, 0}, {-1, 1}, {0, 1}};
+    std::vector<Vector> positions;
+    if (count > 0)
+    {
+        positions.push_back(Vector(0.0, 0.0, 0.0));
+    }
+    for (int ring = 1; positions.size() < count; ++ring)
+    {
+        int q = directions[4][0] * ring;
+        int r = directions[4][1] * ring;
+        for (int side = 0; side < 6 && positions.size() < count; ++side)
+        {
+            for (int step = 0; step < ring && positions.size() < count; ++step)
+            {
+                positions.push_back(
+                    Vector(interSiteDistance * (q + r / 2.0), interSiteDistance * std::sqrt(3.0) / 2 * r, 0.0));
+                q += directions[side][0];
+                r += directions[side][1];
+            }
+        }
+    }
+    return positions;
+}
+
+/**
+ * A BulkSend flow from a remote host to a PacketSink on a UE.
+ * The socket factory is the one of the remote host. A QUIC flow with streams is sent by a
+ * QuicStreamSendApplication over that many streams of its connection instead.
+ *
+ * Several QUIC flows can go to the same port of a UE: they are separate connections accepted by one PacketSink,
+ * sent by QuicStreamSendApplications, and their bytes are told apart by the flow ID of their QuicStreamTags.
+ *
+ * The congestion control of a sender is the one of its protocol (LteQuicTcpScenarioConfig::tcpCongestionControl
+ * and quicCongestionControl, set on the transport protocol of the remote hosts), unless the flow has its own: it is
+ * then sent by a QuicStreamSendApplication, which sets it on its socket.
+ */
+struct ScenarioFlow
+{
+    uint32_t remoteHost;     // Index in LteQuicTcpScenarioConfig::remoteHosts.
+    uint32_t ue;             // Index in LteQuicTcpScenarioConfig::ues.
+    uint16_t port;           // The port of the PacketSink on the UE.
+    uint64_t maxBytes = 0;   // Zero is unlimited.
+    double startTime = 0;    // Start time of the BulkSend application in seconds.
+    int32_t startAfter = -1; // If set, start when this earlier finite flow completes, instead of at startTime.
+    uint32_t streams = 0;    // QUIC only: the number of streams the data is spread over (zero is a plain BulkSend).
+    std::string congestionControl = ""; // The congestion control of the sender, if not the one of its protocol.
+};
+
+/**
+ * The fairness between the flows of a scenario, over the whole run or over a window.
+ */
+struct FairnessSample
+{
+    double time;       // The start of the window, in seconds.
+    double jainIndex;  // Jain's fairness index of the throughputs of the flows running in the window.
+    double shareRatio; // The mean throughput of the QUIC flows over the mean throughput of the TCP flows.
+};
+
+/**
+ * The declarative description of a scenario. The defaults are the parameters of the article.
+ */
+struct LteQuicTcpScenarioConfig
+{
+    double simulationDuration = 40.0; // In seconds. The maximum duration when targetPrecision is set.
+
+    // Stop as soon as the steady-state throughput of every unlimited flow is known within +/- targetPrecision
+    // (relative half-width of its 95% confidence interval), checked every convergenceCheckInterval seconds,
+    // after at least minSteadyStateDuration seconds of steady state. Zero always runs for simulationDuration.
+    double targetPrecision = 0;
+    double convergenceCheckInterval = 1.0;
+    double minSteadyStateDuration = 5.0;
+
+    uint32_t rlcMaxTxBufferSize = 512 * 1024; // The transmission buffer of the eNB.
+    // The fading trace of the UEs: a profile (pedestrian, vehicular, urban or none), a synthetic trace
+    // (<EPA|EVA|ETU>:<Doppler in Hz>:<duration in s>), or a text or binary trace, see fading-trace.h.
+    // A comma-separated list is given to the UEs in turn. No fading if empty.
+    std::string fadingTrace = "src/lte/model/fading-traces/fading_trace.fad";
+    std::string fadingCache = "fading-cache"; // The directory of the synthetic traces and of the binary text traces.
+    double enbTxPower = 46; // In dBm.
+    double ueTxPower = 23;  // In dBm.
+
+    std::string s1uLinkDataRate = "1Gb/s";
+    double s1uLinkDelay = 5; // In milliseconds.
+
+    std::string internetDataRate = "1Gbps"; // The PGW <-> remote host links.
+    std::string internetDelay = "12ms";
+    double errorRate = 0.005; // Packet loss ratio on the PGW <-> remote host links.
+    // The loss model of these links: "rate" (i.i.d., as in the article), "gilbert-elliott" (bursts of lossBurstLength
+    // packets on average, at the mean errorRate) or "trace" (lossTrace replayed, see loss-models.h).
+    std::string lossModel = "rate";
+    double lossBurstLength = 4; // In packets.
+    std::string lossTrace;
+    // Its instances: "shared" by all the devices (as in the article), one per "link", or one per "direction" of every
+    // link. A trace is replayed from a random position by every instance.
+    std::string lossInstances = "shared";
+
+    // The congestion control of the TCP and QUIC senders (see GetCongestionControlTypeId), the default of the stack
+    // if empty:
+    std::string tcpCongestionControl;
+    std::string quicCongestionControl;
+
+    uint32_t sendSize = 512; // The chunk the sources write to their socket.
+    uint32_t sendBatch = 1;  // The number of chunks a source writes to its socket at once.
+    bool mssAligned = false; // The chunk is a full segment of the transport protocol instead of sendSize.
+
+    std::string traces = "none"; // The LTE traces to enable: none, mac, rlc, pdcp or all.
+    // Prepended to the names of the trace files (LTE traces and sender probes): a directory ending in '/', or a name
+    // unique to the process, so that the processes run from the same directory do not overwrite each other's traces.
+    std::string tracePrefix;
+
+    std::vector<Vector> enbPositions; // A single eNB at the origin if empty.
+    std::string handoverAlgorithm = "ns3::A3RsrpHandoverAlgorithm"; // With several eNBs.
+    Rectangle mobilityArea = Rectangle(-1000, 1000, -1000, 1000);   // Where the moving UEs roam.
+
+    bool profile = false;       // Measure the wall time of the phases of the simulation and count its events.
+    bool profileEvents = false; // Also count the events per type (implies profile).
+
+    bool latency = false; // Measure the one-way delay of the data of every flow, from its write to the socket.
+
+    bool probes = false;         // Sample the congestion window, bytes in flight and RTT of the senders.
+    double probeInterval = 0.01; // In seconds.
+
+    double samplingInterval = 0.1; // The bins of the throughput time series of the flows, in seconds.
+    std::string timeSeries;        // A KPI table to append the throughput time series to (none if empty).
+
+    std::vector<TransportProtocol> remoteHosts;
+    std::vector<ScenarioUe> ues;
+    std::vector<ScenarioFlow> flows;
+
+    /**
+     * Add the options shared by all the programs to their command line.
+     */
+    void AddCommandLineValues(CommandLine& cmd)
+    {
+        cmd.AddValue("simulationDuration",
+                     "The duration of the simulation in seconds (its maximum with --targetPrecision)",
+                     simulationDuration);
+        cmd.AddValue("targetPrecision",
+                     "Stop once the 95% confidence interval of the steady-state throughput of every flow is within "
+                     "+/- this fraction of it (0: run for the whole simulationDuration)",
+                     targetPrecision);
+        cmd.AddValue("tcpCongestionControl",
+                     "The congestion control of the TCP senders: NewReno, Cubic, Bbr, ... (default: the ns-3 one)",
+                     tcpCongestionControl);
+        cmd.AddValue("quicCongestionControl",
+                     "The congestion control of the QUIC senders: NewReno, Cubic, Bbr, ... (default: the QUIC module "
+                     "one)",
+                     quicCongestionControl);
+        cmd.AddValue("errorRate", "The packet loss ratio of the links between the PGW and the remote hosts", errorRate);
+        cmd.AddValue("lossModel", "The loss model of these links: rate (i.i.d.), gilbert-elliott or trace", lossModel);
+        cmd.AddValue("lossBurstLength", "The mean length of the loss bursts of gilbert-elliott (in packets)",
+                     lossBurstLength);
+        cmd.AddValue("lossTrace", "The loss trace of the trace loss model: a 1 (lost) or 0 per packet", lossTrace);
+        cmd.AddValue("lossInstances",
+                     "The instances of the loss model: shared by all the links, one per link, or one per direction",
+                     lossInstances);
+        cmd.AddValue("fadingTrace",
+                     "The fading trace of the UEs: pedestrian, vehicular, urban, none, synthetic "
+                     "(EPA|EVA|ETU:<doppler>:<duration>), or a trace file; a comma-separated list is given to the UEs "
+                     "in turn",
+                     fadingTrace);
+        cmd.AddValue("fadingCache", "The directory of the synthetic and converted fading traces", fadingCache);
+        cmd.AddValue("sendSize", "The chunk the sources write to their socket (in bytes)", sendSize);
+        cmd.AddValue("sendBatch", "The number of chunks a source writes to its socket at once", sendBatch);
+        cmd.AddValue("mssAligned",
+                     "Write chunks of a full segment (TCP SegmentSize, QUIC MaxPacketSize) instead of sendSize",
+                     mssAligned);
+        cmd.AddValue("traces",
+                     "The LTE traces to enable: none, mac (binary DlMacStats/UlMacStats), rlc, pdcp or all",
+                     traces);
+        cmd.AddValue("tracePrefix",
+                     "Prepended to the names of the trace files: a directory ending in '/' or a name unique to the "
+                     "process",
+                     tracePrefix);
+        cmd.AddValue("profile", "Print and record the wall time of the phases of the simulation and its event rate",
+                     profile);
+        cmd.AddValue("profileEvents", "Also count the events per subsystem (LTE PHY, MAC, QUIC, TCP, ...)",
+                     profileEvents);
+        cmd.AddValue("latency", "Measure the one-way delay of the data of every flow, and its percentiles", latency);
+        cmd.AddValue("probes", "Sample the congestion window, bytes in flight and RTT of the senders into "
+                     "<tracePrefix>SenderProbes-<run>.bin", probes);
+        cmd.AddValue("probeInterval", "The sampling interval of the probes (in seconds)", probeInterval);
+        cmd.AddValue("samplingInterval", "The interval of the throughput time series of the flows (in seconds)",
+                     samplingInterval);
+        cmd.AddValue("timeSeries", "A KPI table to append the throughput time series of every flow to", timeSeries);
+    }
+
+    /**
+     * The shared options that change the results, as parameters of the results: the congestion controls, the loss
+     * model and the fading, if not the defaults.
+     */
+    std::vector<std::pair<std::string, std::string>> GetParameters() const
+    {
+        std::vector<std::pair<std::string, std::string>> parameters;
+        if (!tcpCongestionControl.empty())
+        {
+            parameters.emplace_back("tcpCongestionControl", tcpCongestionControl);
+        }
+        if (!quicCongestionControl.empty())
+        {
+            parameters.emplace_back("quicCongestionControl", quicCongestionControl);
+        }
+        LteQuicTcpScenarioConfig defaults;
+        if (lossModel != defaults.lossModel || errorRate != defaults.errorRate)
+        {
+            std::ostringstream rate;
+            rate << errorRate;
+            parameters.emplace_back("lossModel", lossModel);
+            parameters.emplace_back("errorRate", rate.str());
+        }
+        if (lossModel == "gilbert-elliott")
+        {
+            std::ostringstream burstLength;
+            burstLength << lossBurstLength;
+            parameters.emplace_back("lossBurstLength", burstLength.str());
+        }
+        if (lossInstances != defaults.lossInstances)
+        {
+            parameters.emplace_back("lossInstances", lossInstances);
+        }
+        if (fadingTrace != defaults.fadingTrace)
+        {
+            parameters.emplace_back("fadingTrace", fadingTrace.empty() ? "none" : fadingTrace);
+        }
+        return parameters;
+    }
+};
+
+/**
+ * Builds the topology of an LteQuicTcpScenarioConfig and installs its flows.
+ *
+ * Usage:
+ *   LteQuicTcpScenario scenario(config);
+ *   scenario.Build();
+ *   scenario.Run();
+ *   ... scenario.GetThroughput(flow), scenario.GetSteadyStateThroughput(flow) ...
+ *   Simulator::Destroy();
+ */
+class LteQuicTcpScenario
+{
+  public:
+    explicit LteQuicTcpScenario(const LteQuicTcpScenarioConfig& config);
+
+    /**
+     * Create the nodes, devices, links, routes and applications.
+     */
+    void Build();
+
+    /**
+     * Run the simulation until the configured duration, until the throughput converges (see
+     * LteQuicTcpScenarioConfig::targetPrecision), or until all the flows are finite and complete.
+     * Simulator::Destroy() is left to the caller, so that the results can be collected first.
+     * The results are only collected by the RAN rank of a distributed simulation, which is also the only one
+     * to stop early: the other ranks run for the configured duration.
+     */
+    void Run();
+
+    /**
+     * The simulated time, in seconds: the configured duration, or less if the simulation stopped early.
+     */
+    double GetDuration() const;
+
+    /**
+     * The wall time of the phases of the simulation and its event counts, with LteQuicTcpScenarioConfig::profile.
+     * The event loop is split into the "attach" phase, until the RRC connection of the last UE, and the "run" phase.
+     * The "traceIo" phase is the time spent writing the MAC traces (during the "run" phase) and the sender probes.
+     */
+    const SimulationProfile& GetProfile() const;
+
+    /**
+     * The one-way delays of the data of a flow, in microseconds, with LteQuicTcpScenarioConfig::latency.
+     * A sample is the delay of a chunk written by the source (or of the part of it in a received packet), from
+     * its write to the socket to its delivery to the sink, including the wait in the send buffer.
+     */
+    const LatencyHistogram& GetLatency(uint32_t flow) const;
+
+    /**
+     * The samples of the congestion control state of the sender of a flow, with LteQuicTcpScenarioConfig::probes
+     * (empty if the sender is simulated by another rank).
+     */
+    const std::vector<SenderProbeRecord>& GetProbeRecords(uint32_t flow) const;
+
+    /**
+     * The latency percentiles of the flows with LteQuicTcpScenarioConfig::latency, as named values for the
+     * results: flow<i>LatencyP50, flow<i>LatencyP95 and flow<i>LatencyP99, in milliseconds.
+     */
+    std::vector<std::pair<std::string, double>> GetLatencyValues() const;
+
+    /**
+     * The handovers of the UEs, in the order they started.
+     */
+    const std::vector<ScenarioHandover>& GetHandovers() const;
+
+    const LteQuicTcpScenarioConfig& GetConfig() const;
+    Ptr<LteHelper> GetLteHelper() const;
+    Ptr<PointToPointEpcHelper> GetEpcHelper() const;
+    Ptr<Node> GetRemoteHost(uint32_t i) const;
+    Ptr<Node> GetUe(uint32_t i) const;
+    Ipv4Address GetUeAddress(uint32_t i) const;
+    Ptr<Application> GetSource(uint32_t flow) const; // Null until a startAfter flow starts, or on another rank.
+    Ptr<PacketSink> GetSink(uint32_t flow) const;     // Shared by the QUIC flows to the same port of a UE.
+
+    /**
+     * The bytes of a flow received by its sink.
+     */
+    uint64_t GetReceivedBytes(uint32_t flow) const;
+
+    /**
+     * The average throughput of a flow over the whole simulation, in Mbps.
+     */
+    double GetThroughput(uint32_t flow) const;
+
+    /**
+     * The throughput time series of a flow, binned at the sink every samplingInterval.
+     */
+    std::vector<ThroughputSample> GetTimeSeries(uint32_t flow) const;
+
+    /**
+     * The throughput of a flow once its initial transient is over (see throughput-sampler.h).
+     */
+    SteadyStateThroughput GetSteadyStateThroughput(uint32_t flow) const;
+
+    /**
+     * The average throughput of a flow since it started, in Mbps.
+     */
+    double GetThroughputSinceStart(uint32_t flow) const;
+
+    /**
+     * The average throughput of a stream of a flow with streams since the flow started, in Mbps.
+     * The streams are numbered from 1.
+     */
+    double GetStreamThroughput(uint32_t flow, uint32_t streamId) const;
+
+    /**
+     * The fairness between all the flows, over their throughputs since they started.
+     */
+    FairnessSample GetFairness() const;
+
+    /**
+     * The fairness between the flows over windows of the given duration (rounded to whole sampling intervals),
+     * sliding by one sampling interval. A window only includes the flows started before it.
+     * It is computed after the run from the throughput samplers of the flows, on purpose: the index of a window only
+     * depends on the bins of the samplers, which already count the bytes of every flow online, so computing it during
+     * the run would give the same values at the cost of an event per sampling interval.
+     */
+    std::vector<FairnessSample> GetFairnessTimeSeries(double window) const;
+
+    /**
+     * The time a flow started, in seconds (negative if it did not start).
+     */
+    double GetStartTime(uint32_t flow) const;
+
+    /**
+     * The time a finite flow received its last byte, in seconds (negative if it did not complete).
+     */
+    double GetCompletionTime(uint32_t flow) const;
+
+  private:
+    void BuildCore();
+    void BuildRemoteHosts();
+    void BuildRadioAccessNetwork();
+    void BuildRemoteRadioAccessNetwork();
+    void InstallFading();
+    bool IsLocal(Ptr<Node> node) const;
+    void InstallFlows();
+    void InstallSource(uint32_t flow);
+    void ConnectProbe(uint32_t flow);
+    uint32_t GetSendSize(TransportProtocol protocol) const;
+    void InstallStack(Ptr<Node> node, TransportProtocol protocol);
+    Ptr<ErrorModel> CreateErrorModel() const;
+    void SetCongestionControl(Ptr<Node> node, TransportProtocol protocol);
+    void EnableTraces();
+    void WriteTimeSeries() const;
+    void CheckConvergence();
+    FairnessSample GetFairness(double time, const std::vector<uint32_t>& flows, const std::vector<double>& throughputs) const;
+    void FlowRx(uint32_t flow, uint64_t bytes);
+    static void SinkRx(LteQuicTcpScenario* scenario, uint32_t flow, Ptr<const Packet> packet, const Address& from);
+    static void ConnectionEstablished(LteQuicTcpScenario* scenario,
+                                      uint32_t ue,
+                                      uint64_t imsi,
+                                      uint16_t cellId,
+                                      uint16_t rnti);
+    static void HandoverStart(LteQuicTcpScenario* scenario,
+                              uint32_t ue,
+                              uint64_t imsi,
+                              uint16_t cellId,
+                              uint16_t rnti,
+                              uint16_t targetCellId);
+    static void HandoverEndOk(LteQuicTcpScenario* scenario, uint32_t ue, uint64_t imsi, uint16_t cellId, uint16_t rnti);
+
+    LteQuicTcpScenarioConfig m_config;
+    Ptr<LteHelper> m_lteHelper;
+    Ptr<MappedTraceFadingLossModel> m_fadingModel; // None without fading.
+    Ptr<PointToPointEpcHelper> m_epcHelper;
+    NodeContainer m_remoteHosts;
+    NodeContainer m_enbNodes;
+    NodeContainer m_ueNodes;
+    NetDeviceContainer m_enbLteDevs;
+    NetDeviceContainer m_ueLteDevs;
+    Ipv4InterfaceContainer m_ueIpIfaces;
+    std::vector<Ptr<Application>> m_sources;
+    std::vector<Ptr<PacketSink>> m_sinks;
+    std::vector<std::unique_ptr<ThroughputSampler>> m_samplers;
+    std::vector<bool> m_taggedFlows; // The flows counted by their QuicStreamTags: with streams, or sharing a sink.
+    std::vector<uint64_t> m_receivedBytes;
+    std::vector<std::vector<uint64_t>> m_streamBytes; // Stream i + 1 at index i, for the flows with streams.
+    std::vector<LatencyHistogram> m_latencies;        // Empty without LteQuicTcpScenarioConfig::latency.
+    std::vector<double> m_startTimes;
+    std::vector<double> m_completionTimes;
+    uint32_t m_completedTransfers = 0;
+    std::vector<ScenarioHandover> m_handovers;
+    std::vector<int64_t> m_pendingHandovers; // The index in m_handovers of the handover of every UE, or -1.
+    double m_duration;
+    std::unique_ptr<LteMacTraceSink> m_macTraceSink;
+    std::unique_ptr<SenderProbe> m_senderProbe;
+    SimulationProfile m_profile;
+    std::vector<bool> m_ueConnected; // With the profile.
+    uint32_t m_connectedUes = 0;
+    std::chrono::steady_clock::time_point m_attachEnd; // The wall time the last UE got connected, if it did.
+};
+
+inline LteQuicTcpScenario::LteQuicTcpScenario(const LteQuicTcpScenarioConfig& config)
+    : m_config(config),
+      m_duration(config.simulationDuration)
+{
+}
+
+inline void
+LteQuicTcpScenario::Build()
+{
+    NS_ABORT_MSG_IF(m_config.ues.empty(), "The scenario has no UEs");
+    NS_ABORT_MSG_IF(m_config.traces != "none" && m_config.traces != "mac" && m_config.traces != "rlc" &&
+                        m_config.traces != "pdcp" && m_config.traces != "all",
+                    "Unknown LTE traces '" << m_config.traces << "'");
+    m_config.profile = m_config.profile || m_config.profileEvents;
+    if (m_config.profileEvents)
+    {
+        EventProfilingScheduler::Reset();
+        ObjectFactory scheduler;
+        scheduler.SetTypeId("ns3::EventProfilingScheduler");
+        Simulator::SetScheduler(scheduler);
+    }
+    m_profile.StartPhase("core");
+    BuildCore();
+    m_profile.StartPhase("remoteHosts");
+    BuildRemoteHosts();
+    m_profile.StartPhase("radioAccessNetwork");
+    BuildRadioAccessNetwork();
+    m_profile.StartPhase("flows");
+    InstallFlows();
+    m_profile.StopPhase();
+}
+
+inline void
+LteQuicTcpScenario::BuildCore()
+{
+    ConfigStore inputConfig;
+    inputConfig.ConfigureDefaults();
+
+    m_lteHelper = CreateObject<LteHelper>();
+
+    Config::SetDefault("ns3::LteRlcUm::MaxTxBufferSize", UintegerValue(m_config.rlcMaxTxBufferSize));
+
+    // Setup LTE propagation loss (the fading is added with the devices, see InstallFading):
+    m_lteHelper->SetPathlossModelType(TypeId::LookupByName("ns3::ThreeLogDistancePropagationLossModel"));
+
+    // Setup the S1-U interface, which connects the E-UTRAN to the EPC:
+    m_epcHelper = CreateObject<PointToPointEpcHelper>();
+    m_epcHelper->SetAttribute("S1uLinkDataRate", DataRateValue(DataRate(m_config.s1uLinkDataRate)));
+    m_epcHelper->SetAttribute("S1uLinkDelay", TimeValue(MilliSeconds(m_config.s1uLinkDelay)));
+
+    // From now on the LTE helper triggers the EPC configuration (S1 links, S1 bearers) whenever
+    // an eNB or a UE is added, or an EPS bearer is created.
+    m_lteHelper->SetEpcHelper(m_epcHelper);
+}
+
+inline void
+LteQuicTcpScenario::BuildRemoteHosts()
+{
+    Ptr<Node> pgw = m_epcHelper->GetPgwNode();
+
+    PointToPointHelper p2ph;
+    p2ph.SetDeviceAttribute("DataRate", StringValue(m_config.internetDataRate));
+    p2ph.SetChannelAttribute("Delay", StringValue(m_config.internetDelay));
+
+    NS_ABORT_MSG_IF(m_config.lossInstances != "shared" && m_config.lossInstances != "link" &&
+                        m_config.lossInstances != "direction",
+                    "Unknown loss model instances '" << m_config.lossInstances << "'");
+    Ptr<ErrorModel> sharedErrorModel = CreateErrorModel(); // By all the devices, by default.
+
+    Ipv4StaticRoutingHelper ipv4RoutingHelper;
+    // Remote host i is simulated by rank 1 + i % (ranks - 1), or by the only rank:
+    uint32_t ranks = GetSimulationRanks();
+    for (uint32_t i = 0; i < m_config.remoteHosts.size(); ++i)
+    {
+        m_remoteHosts.Create(1, ranks > 1 ? 1 + i % (ranks - 1) : 0);
+    }
+    for (uint32_t i = 0; i < m_remoteHosts.GetN(); ++i)
+    {
+        Ptr<Node> remoteHost = m_remoteHosts.Get(i);
+        InstallStack(remoteHost, m_config.remoteHosts[i]);
+        SetCongestionControl(remoteHost, m_config.remoteHosts[i]);
+
+        NetDeviceContainer internetDevices = p2ph.Install(pgw, remoteHost);
+        // The PGW receives the data, the remote host the ACKs:
+        Ptr<ErrorModel> dataErrorModel = m_config.lossInstances == "shared" ? sharedErrorModel : CreateErrorModel();
+        Ptr<ErrorModel> ackErrorModel = m_config.lossInstances == "direction" ? CreateErrorModel() : dataErrorModel;
+        internetDevices.Get(0)->SetAttribute("ReceiveErrorModel", PointerValue(dataErrorModel));
+        internetDevices.Get(1)->SetAttribute("ReceiveErrorModel", PointerValue(ackErrorModel));
+
+        // Each remote host gets its own subnet: 1.0.0.0/8, 2.0.0.0/8, ...
+        Ipv4AddressHelper ipv4h;
+        ipv4h.SetBase(Ipv4Address((i + 1) << 24), "255.0.0.0");
+        ipv4h.Assign(internetDevices);
+
+        // Interface 0 is localhost, 1 is the p2p device:
+        Ptr<Ipv4StaticRouting> remoteHostStaticRouting =
+            ipv4RoutingHelper.GetStaticRouting(remoteHost->GetObject<Ipv4>());
+        remoteHostStaticRouting->AddNetworkRouteTo(m_epcHelper->GetUeDefaultGatewayAddress(), Ipv4Mask("255.0.0.0"), 1);
+    }
+}
+
+inline void
+LteQuicTcpScenario::BuildRadioAccessNetwork()
+{
+    std::vector<Vector> enbPositions = m_config.enbPositions;
+    if (enbPositions.empty())
+    {
+        enbPositions.push_back(Vector(0.0, 0.0, 0.0));
+    }
+    m_enbNodes.Create(enbPositions.size());
+    m_ueNodes.Create(m_config.ues.size());
+    if (!IsLocal(m_enbNodes.Get(0)))
+    {
+        BuildRemoteRadioAccessNetwork();
+        return;
+    }
+
+    // The eNBs and the fixed UEs are where the config puts them:
+    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+    for (const Vector& position : enbPositions)
+    {
+        positionAlloc->Add(position);
+    }
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.Install(m_enbNodes);
+
+    // The moving UEs go from random waypoint to random waypoint of the mobility area, without pausing:
+    Ptr<RandomRectanglePositionAllocator> waypoints = CreateObject<RandomRectanglePositionAllocator>();
+    Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable>();
+    x->SetAttribute("Min", DoubleValue(m_config.mobilityArea.xMin));
+    x->SetAttribute("Max", DoubleValue(m_config.mobilityArea.xMax));
+    Ptr<UniformRandomVariable> y = CreateObject<UniformRandomVariable>();
+    y->SetAttribute("Min", DoubleValue(m_config.mobilityArea.yMin));
+    y->SetAttribute("Max", DoubleValue(m_config.mobilityArea.yMax));
+    waypoints->SetX(x);
+    waypoints->SetY(y);
+    for (uint32_t i = 0; i < m_ueNodes.GetN(); ++i)
+    {
+        const ScenarioUe& ue = m_config.ues[i];
+        if (ue.speed > 0)
+        {
+            Ptr<RandomWaypointMobilityModel> model = CreateObject<RandomWaypointMobilityModel>();
+            Ptr<ConstantRandomVariable> speed = CreateObject<ConstantRandomVariable>();
+            speed->SetAttribute("Constant", DoubleValue(ue.speed));
+            model->SetAttribute("Speed", PointerValue(speed));
+            model->SetAttribute("Pause", StringValue("ns3::ConstantRandomVariable[Constant=0]"));
+            model->SetAttribute("PositionAllocator", PointerValue(waypoints));
+            model->SetPosition(waypoints->GetNext());
+            m_ueNodes.Get(i)->AggregateObject(model);
+        }
+        else
+        {
+            Ptr<ConstantPositionMobilityModel> model = CreateObject<ConstantPositionMobilityModel>();
+            model->SetPosition(ue.position);
+            m_ueNodes.Get(i)->AggregateObject(model);
+        }
+    }
+
+    // Every cell of a large grid may serve many UEs, and each of them needs an SRS slot in its cell:
+    uint32_t srsPeriodicity = 40; // The ns-3 default, in ms, then 80, 160 or 320.
+    while (srsPeriodicity < m_config.ues.size() && srsPeriodicity < 320)
+    {
+        srsPeriodicity *= 2;
+    }
+    Config::SetDefault("ns3::LteEnbRrc::SrsPeriodicity", UintegerValue(srsPeriodicity));
+
+    if (m_enbNodes.GetN() > 1)
+    {
+        m_lteHelper->SetHandoverAlgorithmType(m_config.handoverAlgorithm);
+    }
+    m_enbLteDevs = m_lteHelper->InstallEnbDevice(m_enbNodes);
+    m_ueLteDevs = m_lteHelper->InstallUeDevice(m_ueNodes);
+    InstallFading();
+
+    for (uint32_t i = 0; i < m_enbLteDevs.GetN(); ++i)
+    {
+        m_enbLteDevs.Get(i)->GetObject<LteEnbNetDevice>()->GetPhy()->SetTxPower(m_config.enbTxPower);
+    }
+    for (uint32_t i = 0; i < m_ueLteDevs.GetN(); ++i)
+    {
+        m_ueLteDevs.Get(i)->GetObject<LteUeNetDevice>()->GetPhy()->SetTxPower(m_config.ueTxPower);
+    }
+
+    // Install the IP stack on the UEs and set their default gateway:
+    for (uint32_t i = 0; i < m_ueNodes.GetN(); ++i)
+    {
+        InstallStack(m_ueNodes.Get(i), m_config.ues[i].protocol);
+    }
+    m_ueIpIfaces = m_epcHelper->AssignUeIpv4Address(m_ueLteDevs);
+    Ipv4StaticRoutingHelper ipv4RoutingHelper;
+    for (uint32_t i = 0; i < m_ueNodes.GetN(); ++i)
+    {
+        Ptr<Ipv4StaticRouting> ueStaticRouting =
+            ipv4RoutingHelper.GetStaticRouting(m_ueNodes.Get(i)->GetObject<Ipv4>());
+        ueStaticRouting->SetDefaultRoute(m_epcHelper->GetUeDefaultGatewayAddress(), 1);
+    }
+
+    // The attach itself is simulated at the start of the event loop (RRC connection, then the default EPS bearer),
+    // which the profile splits into its "attach" and "run" phases when the last UE is connected:
+    if (m_config.profile)
+    {
+        m_ueConnected.assign(m_ueLteDevs.GetN(), false);
+        for (uint32_t i = 0; i < m_ueLteDevs.GetN(); ++i)
+        {
+            Ptr<LteUeRrc> rrc = m_ueLteDevs.Get(i)->GetObject<LteUeNetDevice>()->GetRrc();
+            rrc->TraceConnectWithoutContext("ConnectionEstablished",
+                                            MakeBoundCallback(&LteQuicTcpScenario::ConnectionEstablished, this, i));
+        }
+    }
+
+    // Attach the UEs to the eNB, or to the best cell:
+    if (m_enbNodes.GetN() == 1)
+    {
+        for (uint32_t i = 0; i < m_ueLteDevs.GetN(); ++i)
+        {
+            m_lteHelper->Attach(m_ueLteDevs.Get(i), m_enbLteDevs.Get(0));
+        }
+        return;
+    }
+    m_lteHelper->Attach(m_ueLteDevs);
+    m_lteHelper->AddX2Interface(m_enbNodes);
+    m_pendingHandovers.assign(m_ueLteDevs.GetN(), -1);
+    for (uint32_t i = 0; i < m_ueLteDevs.GetN(); ++i)
+    {
+        Ptr<LteUeRrc> rrc = m_ueLteDevs.Get(i)->GetObject<LteUeNetDevice>()->GetRrc();
+        rrc->TraceConnectWithoutContext("HandoverStart",
+                                        MakeBoundCallback(&LteQuicTcpScenario::HandoverStart, this, i));
+        rrc->TraceConnectWithoutContext("HandoverEndOk",
+                                        MakeBoundCallback(&LteQuicTcpScenario::HandoverEndOk, this, i));
+    }
+}
+
+/**
+ * Add the fading of the UEs to the channels of the LteHelper, which exist once it installed the eNBs. Unlike
+ * LteHelper::SetFadingModel, the model is ours, so every UE gets its own trace.
+ */
+inline void
+LteQuicTcpScenario::InstallFading()
+{
+    std::vector<std::string> traces;
+    std::istringstream list(m_config.fadingTrace);
+    std::string trace;
+    while (std::getline(list, trace, ','))
+    {
+        traces.push_back(trace);
+    }
+    bool fading = false;
+    for (const ScenarioUe& ue : m_config.ues)
+    {
+        fading = fading || !ue.fadingTrace.empty();
+    }
+    if (traces.empty() && !fading)
+    {
+        return;
+    }
+
+    // The traces are loaded (converted or generated if needed) here, so that the run does not pay for it and a
+    // wrong trace aborts before the simulation starts:
+    m_fadingModel = CreateObject<MappedTraceFadingLossModel>();
+    m_fadingModel->SetAttribute("CacheDirectory", StringValue(m_config.fadingCache));
+    m_fadingModel->SetAttribute("PlayDuration", TimeValue(Seconds(m_config.simulationDuration)));
+    // A fixed stream (the automatic ones are above 2^63), so that the trace offsets of the links do not depend on
+    // the order the other random variables are created in:
+    m_fadingModel->AssignStreams(0);
+    for (uint32_t i = 0; i < m_ueNodes.GetN(); ++i)
+    {
+        const ScenarioUe& ue = m_config.ues[i];
+        trace = !ue.fadingTrace.empty() ? ue.fadingTrace : (traces.empty() ? "none" : traces[i % traces.size()]);
+        try
+        {
+            m_fadingModel->SetUeTrace(m_ueNodes.Get(i)->GetObject<MobilityModel>(), trace);
+        }
+        catch (const std::exception& e)
+        {
+            // The generator of the synthetic traces (fading-generator.h) does not depend on ns-3, and throws:
+            NS_ABORT_MSG("The fading trace " << trace << " of UE " << i << ": " << e.what());
+        }
+    }
+    m_lteHelper->GetDownlinkSpectrumChannel()->AddSpectrumPropagationLossModel(m_fadingModel);
+    m_lteHelper->GetUplinkSpectrumChannel()->AddSpectrumPropagationLossModel(m_fadingModel);
+}
+
+inline void
+LteQuicTcpScenario::BuildRemoteRadioAccessNetwork()
+{
+    // Another rank simulates the RAN, the sources of this one only need the addresses of the UEs. Placeholder
+    // devices get them from the EPC, in the same order as the LTE devices of the RAN rank.
+    NetDeviceContainer placeholders;
+    for (uint32_t i = 0; i < m_ueNodes.GetN(); ++i)
+    {
+        InstallStack(m_ueNodes.Get(i), m_config.ues[i].protocol);
+        Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+        m_ueNodes.Get(i)->AddDevice(device);
+        placeholders.Add(device);
+    }
+    m_ueIpIfaces = m_epcHelper->AssignUeIpv4Address(placeholders);
+}
+
+inline bool
+LteQuicTcpScenario::IsLocal(Ptr<Node> node) const
+{
+    return node->GetSystemId() == Simulator::GetSystemId();
+}
+
+inline void
+LteQuicTcpScenario::ConnectionEstablished(LteQuicTcpScenario* scenario, uint32_t ue, uint64_t, uint16_t, uint16_t)
+{
+    if (scenario->m_ueConnected[ue])
+    {
+        return; // Connected again after a radio link failure.
+    }
+    scenario->m_ueConnected[ue] = true;
+    if (++scenario->m_connectedUes == scenario->m_ueConnected.size())
+    {
+        scenario->m_attachEnd = std::chrono::steady_clock::now();
+    }
+}
+
+inline void
+LteQuicTcpScenario::HandoverStart(LteQuicTcpScenario* scenario,
+                                  uint32_t ue,
+                                  uint64_t,
+                                  uint16_t cellId,
+                                  uint16_t,
+                                  uint16_t targetCellId)
+{
+    scenario->m_pendingHandovers[ue] = scenario->m_handovers.size();
+    scenario->m_handovers.push_back({ue, cellId, targetCellId, Simulator::Now().GetSeconds(), -1});
+}
+
+inline void
+LteQuicTcpScenario::HandoverEndOk(LteQuicTcpScenario* scenario, uint32_t ue, uint64_t, uint16_t, uint16_t)
+{
+    if (scenario->m_pendingHandovers[ue] >= 0)
+    {
+        scenario->m_handovers[scenario->m_pendingHandovers[ue]].endTime = Simulator::Now().GetSeconds();
+        scenario->m_pendingHandovers[ue] = -1;
+    }
+}
+
+inline void
+LteQuicTcpScenario::InstallFlows()
+{
+    NS_ABORT_MSG_IF(m_config.samplingInterval <= 0, "The sampling interval must be positive");
+    auto samplerCapacity = static_cast<uint32_t>(std::ceil(m_config.simulationDuration / m_config.samplingInterval));
+    m_sources.resize(m_config.flows.size());
+    m_startTimes.assign(m_config.flows.size(), -1);
+    m_completionTimes.assign(m_config.flows.size(), -1);
+    m_receivedBytes.assign(m_config.flows.size(), 0);
+    m_latencies.resize(m_config.latency ? m_config.flows.size() : 0);
+    if (m_config.probes)
+    {
+        m_senderProbe = std::make_unique<SenderProbe>(m_config.flows.size(), Seconds(m_config.probeInterval),
+                                                      Seconds(m_config.simulationDuration));
+    }
+
+    // The flows to every port of every UE, which share its sink:
+    std::map<std::pair<uint32_t, uint16_t>, uint32_t> portFlows;
+    for (const ScenarioFlow& flow : m_config.flows)
+    {
+        ++portFlows[{flow.ue, flow.port}];
+    }
+    std::map<std::pair<uint32_t, uint16_t>, Ptr<PacketSink>> sinks;
+    for (uint32_t i = 0; i < m_config.flows.size(); ++i)
+    {
+        const ScenarioFlow& flow = m_config.flows[i];
+        NS_ABORT_MSG_IF(flow.remoteHost >= m_remoteHosts.GetN(), "Flow from an unknown remote host");
+        NS_ABORT_MSG_IF(flow.ue >= m_ueNodes.GetN(), "Flow to an unknown UE");
+        TransportProtocol protocol = m_config.remoteHosts[flow.remoteHost];
+        NS_ABORT_MSG_IF(protocol == TransportProtocol::QUIC &&
+                            m_config.ues[flow.ue].protocol != TransportProtocol::QUIC,
+                        "A QUIC flow needs a QUIC UE");
+        NS_ABORT_MSG_IF(flow.startAfter >= static_cast<int32_t>(i) ||
+                            (flow.startAfter >= 0 && m_config.flows[flow.startAfter].maxBytes == 0),
+                        "A flow can only start after an earlier finite flow");
+        NS_ABORT_MSG_IF(flow.startAfter >= 0 && GetSimulationRanks() > 1,
+                        "A distributed simulation cannot start a flow after another one");
+        NS_ABORT_MSG_IF(flow.streams > 0 && protocol != TransportProtocol::QUIC, "Only QUIC flows have streams");
+        bool sharedPort = portFlows[{flow.ue, flow.port}] > 1;
+        NS_ABORT_MSG_IF(sharedPort && protocol != TransportProtocol::QUIC,
+                        "Only QUIC flows can share a port of a UE (port " << flow.port << ")");
+        m_taggedFlows.push_back(flow.streams > 0 || sharedPort || m_config.latency || !flow.congestionControl.empty());
+        m_streamBytes.emplace_back(flow.streams, 0);
+        m_samplers.push_back(std::make_unique<ThroughputSampler>(Seconds(m_config.samplingInterval), samplerCapacity));
+
+        // The sources that start after another flow are installed when it completes (see FlowRx):
+        if (flow.startAfter < 0)
+        {
+            InstallSource(i);
+        }
+
+        // A QUIC PacketSink accepts every connection to its port, so the flows to a port share the first one's:
+        Ptr<PacketSink>& sink = sinks[{flow.ue, flow.port}];
+        if (!sink && IsLocal(m_ueNodes.Get(flow.ue)))
+        {
+            PacketSinkHelper packetSinkHelper(GetSocketFactoryName(protocol),
+                                              InetSocketAddress(Ipv4Address::GetAny(), flow.port));
+            if (protocol == TransportProtocol::QUIC)
+            {
+                packetSinkHelper.SetAttribute("Protocol", TypeIdValue(QuicSocketFactory::GetTypeId()));
+            }
+            ApplicationContainer sinkApps = packetSinkHelper.Install(m_ueNodes.Get(flow.ue));
+            sinkApps.Start(Seconds(0));
+            sinkApps.Stop(Seconds(m_config.simulationDuration));
+            sink = DynamicCast<PacketSink>(sinkApps.Get(0));
+            sink->TraceConnectWithoutContext("Rx", MakeBoundCallback(&LteQuicTcpScenario::SinkRx, this, i));
+        }
+        m_sinks.push_back(sink);
+    }
+}
+
+inline void
+LteQuicTcpScenario::InstallSource(uint32_t flow)
+{
+    const ScenarioFlow& config = m_config.flows[flow];
+
+    // The start and stop times of an application are relative to the time it is installed at:
+    Time now = Simulator::Now();
+    Time start = config.startAfter < 0 ? Seconds(config.startTime) : now;
+    m_startTimes[flow] = start.GetSeconds();
+    if (!IsLocal(m_remoteHosts.Get(config.remoteHost)))
+    {
+        return; // Another rank simulates it.
+    }
+
+    TransportProtocol protocol = m_config.remoteHosts[config.remoteHost];
+    std::string socketFactory = GetSocketFactoryName(protocol);
+    Address remoteAddr(InetSocketAddress(m_ueIpIfaces.GetAddress(config.ue), config.port));
+    ApplicationContainer sourceApps;
+    if (m_taggedFlows[flow])
+    {
+        Ptr<QuicStreamSendApplication> source = CreateObject<QuicStreamSendApplication>();
+        source->SetAttribute("Protocol", TypeIdValue(TypeId::LookupByName(socketFactory)));
+        source->SetAttribute("Remote", AddressValue(remoteAddr));
+        source->SetAttribute("MaxBytes", UintegerValue(config.maxBytes));
+        source->SetAttribute("SendSize", UintegerValue(GetSendSize(protocol)));
+        source->SetAttribute("Streams", UintegerValue(std::max<uint32_t>(1, config.streams)));
+        source->SetAttribute("FlowId", UintegerValue(flow));
+        if (!config.congestionControl.empty())
+        {
+            source->SetAttribute("CongestionControl",
+                                 TypeIdValue(GetCongestionControlTypeId(protocol, config.congestionControl)));
+        }
+        m_remoteHosts.Get(config.remoteHost)->AddApplication(source);
+        sourceApps.Add(source);
+    }
+    else
+    {
+        BulkSendHelper bulkSendHelper(socketFactory, remoteAddr);
+        bulkSendHelper.SetAttribute("MaxBytes", UintegerValue(config.maxBytes));
+        bulkSendHelper.SetAttribute("SendSize", UintegerValue(GetSendSize(protocol)));
+        sourceApps = bulkSendHelper.Install(m_remoteHosts.Get(config.remoteHost));
+    }
+
+    sourceApps.Start(start - now);
+    sourceApps.Stop(Seconds(m_config.simulationDuration) - now);
+    m_sources[flow] = sourceApps.Get(0);
+    if (m_senderProbe)
+    {
+        // The source creates its socket when it starts, which is after the events already scheduled then:
+        Simulator::Schedule(start - now + TimeStep(1), &LteQuicTcpScenario::ConnectProbe, this, flow);
+    }
+}
+
+inline void
+LteQuicTcpScenario::ConnectProbe(uint32_t flow)
+{
+    Ptr<Socket> socket;
+    if (Ptr<QuicStreamSendApplication> source = DynamicCast<QuicStreamSendApplication>(m_sources[flow]))
+    {
+        socket = source->GetSocket();
+    }
+    else
+    {
+        socket = DynamicCast<BulkSendApplication>(m_sources[flow])->GetSocket();
+    }
+    if (socket)
+    {
+        m_senderProbe->Connect(flow, socket);
+    }
+}
+
+/**
+ * Every write to a socket costs a few events of the application and the socket, whatever its size: the default
+ * 512-byte chunks cost several writes per segment. A write is split into segments by the socket anyway, so
+ * larger or segment-aligned writes only cut the per-write overhead; a write must fit in the send buffer.
+ */
+inline uint32_t
+LteQuicTcpScenario::GetSendSize(TransportProtocol protocol) const
+{
+    uint64_t chunk = m_config.sendSize;
+    uint64_t sendBuffer = GetDefaultUinteger("ns3::TcpSocket", "SndBufSize");
+    if (protocol == TransportProtocol::QUIC)
+    {
+        sendBuffer = GetDefaultUinteger("ns3::QuicSocketBase", "SocketSndBufSize");
+    }
+    if (m_config.mssAligned)
+    {
+        chunk = protocol == TransportProtocol::QUIC ? GetDefaultUinteger("ns3::QuicSocketBase", "MaxPacketSize")
+                                                    : GetDefaultUinteger("ns3::TcpSocket", "SegmentSize");
+    }
+    uint64_t sendSize = chunk * m_config.sendBatch;
+    NS_ABORT_MSG_IF(sendSize == 0 || sendSize > sendBuffer,
+                    "The " << GetProtocolName(protocol) << " sources write " << sendSize
+                           << " bytes at once, which must be positive and fit in the send buffer (" << sendBuffer
+                           << " bytes)");
+    return sendSize;
+}
+
+inline void
+LteQuicTcpScenario::SinkRx(LteQuicTcpScenario* scenario, uint32_t flow, Ptr<const Packet> packet, const Address&)
+{
+    if (!scenario->m_taggedFlows[flow])
+    {
+        scenario->FlowRx(flow, packet->GetSize()); // The only flow of its sink.
+        return;
+    }
+    ByteTagIterator tags = packet->GetByteTagIterator();
+    while (tags.HasNext())
+    {
+        ByteTagIterator::Item item = tags.Next();
+        if (item.GetTypeId() != QuicStreamTag::GetTypeId())
+        {
+            continue;
+        }
+        QuicStreamTag tag;
+        item.GetTag(tag);
+        uint32_t tagFlow = tag.GetFlowId();
+        if (tagFlow >= scenario->m_config.flows.size() || !scenario->m_taggedFlows[tagFlow])
+        {
+            continue;
+        }
+        uint32_t bytes = item.GetEnd() - item.GetStart();
+        std::vector<uint64_t>& streamBytes = scenario->m_streamBytes[tagFlow];
+        if (tag.GetStreamId() >= 1 && tag.GetStreamId() <= streamBytes.size())
+        {
+            streamBytes[tag.GetStreamId() - 1] += bytes;
+        }
+        if (!scenario->m_latencies.empty())
+        {
+            scenario->m_latencies[tagFlow].Add((Simulator::Now() - tag.GetSendTime()).GetMicroSeconds());
+        }
+        scenario->FlowRx(tagFlow, bytes);
+    }
+}
+
+inline void
+LteQuicTcpScenario::FlowRx(uint32_t flow, uint64_t bytes)
+{
+    m_receivedBytes[flow] += bytes;
+    m_samplers[flow]->AddBytes(bytes);
+    if (m_config.flows[flow].maxBytes == 0 || m_completionTimes[flow] >= 0 ||
+        m_receivedBytes[flow] < m_config.flows[flow].maxBytes)
+    {
+        return;
+    }
+    m_completionTimes[flow] = Simulator::Now().GetSeconds();
+    for (uint32_t next = flow + 1; next < m_config.flows.size(); ++next)
+    {
+        if (m_config.flows[next].startAfter == static_cast<int32_t>(flow))
+        {
+            InstallSource(next);
+        }
+    }
+    // Nothing is left to measure once the last transfer is complete, only LTE control traffic to simulate:
+    if (++m_completedTransfers == m_config.flows.size())
+    {
+        Simulator::Stop();
+    }
+}
+
+inline void
+LteQuicTcpScenario::InstallStack(Ptr<Node> node, TransportProtocol protocol)
+{
+    if (protocol == TransportProtocol::QUIC)
+    {
+        QuicHelper quicStack;
+        quicStack.InstallQuic(NodeContainer(node));
+    }
+    else
+    {
+        InternetStackHelper internet;
+        internet.Install(node);
+    }
+}
+
+inline Ptr<ErrorModel>
+LteQuicTcpScenario::CreateErrorModel() const
+{
+    if (m_config.lossModel == "gilbert-elliott")
+    {
+        auto [goodToBad, badToGood] = GetGilbertElliottTransitions(m_config.errorRate, m_config.lossBurstLength);
+        Ptr<GilbertElliottErrorModel> errorModel = CreateObject<GilbertElliottErrorModel>();
+        errorModel->SetAttribute("GoodToBad", DoubleValue(goodToBad));
+        errorModel->SetAttribute("BadToGood", DoubleValue(badToGood));
+        return errorModel;
+    }
+    if (m_config.lossModel == "trace")
+    {
+        NS_ABORT_MSG_IF(m_config.lossTrace.empty(), "The trace loss model needs a lossTrace");
+        Ptr<UniformRandomVariable> offset = CreateObject<UniformRandomVariable>();
+        Ptr<TraceErrorModel> errorModel = CreateObject<TraceErrorModel>();
+        errorModel->SetAttribute("TraceFile", StringValue(m_config.lossTrace));
+        errorModel->SetAttribute("Offset", UintegerValue(offset->GetInteger(0, UINT32_MAX)));
+        return errorModel;
+    }
+    NS_ABORT_MSG_IF(m_config.lossModel != "rate", "Unknown loss model '" << m_config.lossModel << "'");
+    Ptr<RateErrorModel> errorModel = CreateObject<RateErrorModel>();
+    errorModel->SetAttribute("ErrorRate", DoubleValue(m_config.errorRate));
+    errorModel->SetAttribute("ErrorUnit", StringValue("ERROR_UNIT_PACKET"));
+    return errorModel;
+}
+
+inline void
+LteQuicTcpScenario::SetCongestionControl(Ptr<Node> node, TransportProtocol protocol)
+{
+    if (protocol == TransportProtocol::QUIC && !m_config.quicCongestionControl.empty())
+    {
+        TypeId tid = GetCongestionControlTypeId(protocol, m_config.quicCongestionControl);
+        node->GetObject<QuicL4Protocol>()->SetAttribute("SocketType", TypeIdValue(tid));
+    }
+    else if (protocol == TransportProtocol::TCP && !m_config.tcpCongestionControl.empty())
+    {
+        TypeId tid = GetCongestionControlTypeId(protocol, m_config.tcpCongestionControl);
+        node->GetObject<TcpL4Protocol>()->SetAttribute("SocketType", TypeIdValue(tid));
+    }
+}
+
+inline void
+LteQuicTcpScenario::EnableTraces()
+{
+    const std::string& traces = m_config.traces;
+    if (!IsLocal(m_enbNodes.Get(0)))
+    {
+        return; // Another rank simulates the RAN.
+    }
+    if (traces == "mac" || traces == "all")
+    {
+        m_macTraceSink = std::make_unique<LteMacTraceSink>(m_config.tracePrefix, RngSeedManager::GetRun());
+        m_macTraceSink->Connect(m_enbLteDevs);
+    }
+    // The RLC and PDCP statistics are aggregated over epochs by ns-3 before they are written,
+    // so their text files are cheap enough to keep.
+    if (traces == "rlc" || traces == "all")
+    {
+        m_lteHelper->EnableRlcTraces();
+        m_lteHelper->GetRlcStats()->SetDlOutputFilename(m_config.tracePrefix + "DlRlcStats.txt");
+        m_lteHelper->GetRlcStats()->SetUlOutputFilename(m_config.tracePrefix + "UlRlcStats.txt");
+    }
+    if (traces == "pdcp" || traces == "all")
+    {
+        m_lteHelper->EnablePdcpTraces();
+        m_lteHelper->GetPdcpStats()->SetDlPdcpOutputFilename(m_config.tracePrefix + "DlPdcpStats.txt");
+        m_lteHelper->GetPdcpStats()->SetUlPdcpOutputFilename(m_config.tracePrefix + "UlPdcpStats.txt");
+    }
+}
+
+inline void
+LteQuicTcpScenario::Run()
+{
+    m_profile.StartPhase("traces");
+    EnableTraces();
+    m_profile.StopPhase();
+    if (m_config.targetPrecision > 0)
+    {
+        Simulator::Schedule(Seconds(m_config.convergenceCheckInterval), &LteQuicTcpScenario::CheckConvergence, this);
+    }
+    Simulator::Stop(Seconds(m_config.simulationDuration));
+    uint64_t events = Simulator::GetEventCount();
+    auto start = std::chrono::steady_clock::now();
+    Simulator::Run();
+    auto end = std::chrono::steady_clock::now();
+    std::chrono::duration<double> runWallTime = end - start;
+    m_duration = Simulator::Now().GetSeconds();
+    if (m_connectedUes > 0 && m_connectedUes == m_ueConnected.size())
+    {
+        m_profile.AddPhase("attach", std::chrono::duration<double>(m_attachEnd - start).count());
+        m_profile.AddPhase("run", std::chrono::duration<double>(end - m_attachEnd).count());
+    }
+    else
+    {
+        m_profile.AddPhase("run", runWallTime.count()); // Not all the UEs attached, or on another rank.
+    }
+    m_profile.SetEvents(Simulator::GetEventCount() - events, runWallTime.count(), m_duration);
+
+    if (m_macTraceSink || m_senderProbe)
+    {
+        double writeTime = 0;
+        if (m_macTraceSink)
+        {
+            m_macTraceSink->Flush();
+            writeTime += m_macTraceSink->GetWriteTime();
+        }
+        if (m_senderProbe)
+        {
+            // The senders of a distributed simulation are spread over the ranks, each writes its own:
+            int32_t rank = GetSimulationRanks() > 1 ? static_cast<int32_t>(Simulator::GetSystemId()) : -1;
+            m_senderProbe->Write(
+                GetTraceFileName(m_config.tracePrefix, "SenderProbes", RngSeedManager::GetRun(), rank));
+            writeTime += m_senderProbe->GetWriteTime();
+        }
+        m_profile.AddPhase("traceIo", writeTime);
+    }
+    m_profile.StartPhase("timeSeries");
+    WriteTimeSeries();
+    m_profile.StopPhase();
+
+    if (m_config.profileEvents)
+    {
+        m_profile.SetEventTypes(EventProfilingScheduler::GetCounts());
+    }
+    if (m_config.profile)
+    {
+        m_profile.Print(std::clog); // Next to the KPIs on the standard output, which the scripts parse.
+    }
+    if (!m_latencies.empty() && IsLocal(m_ueNodes.Get(0)))
+    {
+        for (uint32_t flow = 0; flow < m_latencies.size(); ++flow)
+        {
+            const LatencyHistogram& latency = m_latencies[flow];
+            std::clog << "LATENCY flow " << flow << ": p50 " << latency.GetPercentile(50) / 1000 << " ms, p95 "
+                      << latency.GetPercentile(95) / 1000 << " ms, p99 " << latency.GetPercentile(99) / 1000
+                      << " ms (" << latency.GetCount() << " samples)" << std::endl;
+        }
+    }
+}
+
+inline void
+LteQuicTcpScenario::CheckConvergence()
+{
+    Time now = Simulator::Now();
+    bool converged = false;
+    for (uint32_t flow = 0; flow < m_samplers.size(); ++flow)
+    {
+        if (m_config.flows[flow].maxBytes != 0)
+        {
+            continue; // Finite transfers have no steady state.
+        }
+        SteadyStateThroughput steadyState = m_samplers[flow]->GetSteadyState(now);
+        converged = steadyState.throughput > 0 &&
+                    now.GetSeconds() - steadyState.start >= m_config.minSteadyStateDuration &&
+                    steadyState.confidenceInterval95 <= m_config.targetPrecision * steadyState.throughput;
+        if (!converged)
+        {
+            break;
+        }
+    }
+    if (converged)
+    {
+        Simulator::Stop();
+    }
+    else
+    {
+        Simulator::Schedule(Seconds(m_config.convergenceCheckInterval), &LteQuicTcpScenario::CheckConvergence, this);
+    }
+}
+
+inline void
+LteQuicTcpScenario::WriteTimeSeries() const
+{
+    if (m_config.timeSeries.empty() || !IsLocal(m_ueNodes.Get(0)))
+    {
+        return; // The sinks are all on the RAN rank.
+    }
+    KpiTable table;
+    for (uint32_t flow = 0; flow < m_samplers.size(); ++flow)
+    {
+        for (const ThroughputSample& sample : GetTimeSeries(flow))
+        {
+            size_t row = table.AddRow();
+            table.Set(row, "seed", KpiColumnRole::ID, static_cast<int64_t>(RngSeedManager::GetSeed()));
+            table.Set(row, "run", KpiColumnRole::ID, static_cast<int64_t>(RngSeedManager::GetRun()));
+            table.Set(row, "flow", KpiColumnRole::ID, static_cast<int64_t>(flow));
+            table.Set(row, "protocol", KpiColumnRole::ID,
+                      GetProtocolName(m_config.remoteHosts[m_config.flows[flow].remoteHost]));
+            table.Set(row, "time", KpiColumnRole::ID, sample.time);
+            table.Set(row, "throughput", KpiColumnRole::KPI, sample.throughput);
+        }
+    }
+    try
+    {
+        table.AppendTo(m_config.timeSeries);
+    }
+    catch (const std::exception& e)
+    {
+        NS_ABORT_MSG(e.what());
+    }
+}
+
+inline const SimulationProfile&
+LteQuicTcpScenario::GetProfile() const
+{
+    return m_profile;
+}
+
+inline const LatencyHistogram&
+LteQuicTcpScenario::GetLatency(uint32_t flow) const
+{
+    NS_ABORT_MSG_IF(m_latencies.empty(), "The latency is only measured with LteQuicTcpScenarioConfig::latency");
+    return m_latencies.at(flow);
+}
+
+inline const std::vector<SenderProbeRecord>&
+LteQuicTcpScenario::GetProbeRecords(uint32_t flow) const
+{
+    NS_ABORT_MSG_IF(!m_senderProbe, "The senders are only probed with LteQuicTcpScenarioConfig::probes");
+    return m_senderProbe->GetRecords(flow);
+}
+
+inline std::vector<std::pair<std::string, double>>
+LteQuicTcpScenario::GetLatencyValues() const
+{
+    std::vector<std::pair<std::string, double>> values;
+    for (uint32_t flow = 0; flow < m_latencies.size(); ++flow)
+    {
+        if (m_latencies[flow].GetCount() == 0)
+        {
+            continue;
+        }
+        std::string prefix = "flow" + std::to_string(flow) + "Latency";
+        values.emplace_back(prefix + "P50", m_latencies[flow].GetPercentile(50) / 1000);
+        values.emplace_back(prefix + "P95", m_latencies[flow].GetPercentile(95) / 1000);
+        values.emplace_back(prefix + "P99", m_latencies[flow].GetPercentile(99) / 1000);
+    }
+    return values;
+}
+
+inline const std::vector<ScenarioHandover>&
+LteQuicTcpScenario::GetHandovers() const
+{
+    return m_handovers;
+}
+
+inline const LteQuicTcpScenarioConfig&
+LteQuicTcpScenario::GetConfig() const
+{
+    return m_config;
+}
+
+inline double
+LteQuicTcpScenario::GetStartTime(uint32_t flow) const
+{
+    return m_startTimes.at(flow);
+}
+
+inline double
+LteQuicTcpScenario::GetCompletionTime(uint32_t flow) const
+{
+    return m_completionTimes.at(flow);
+}
+
+inline double
+LteQuicTcpScenario::GetDuration() const
+{
+    return m_duration;
+}
+
+inline Ptr<LteHelper>
+LteQuicTcpScenario::GetLteHelper() const
+{
+    return m_lteHelper;
+}
+
+inline Ptr<PointToPointEpcHelper>
+LteQuicTcpScenario::GetEpcHelper() const
+{
+    return m_epcHelper;
+}
+
+inline Ptr<Node>
+LteQuicTcpScenario::GetRemoteHost(uint32_t i) const
+{
+    return m_remoteHosts.Get(i);
+}
+
+inline Ptr<Node>
+LteQuicTcpScenario::GetUe(uint32_t i) const
+{
+    return m_ueNodes.Get(i);
+}
+
+inline Ipv4Address
+LteQuicTcpScenario::GetUeAddress(uint32_t i) const
+{
+    return m_ueIpIfaces.GetAddress(i);
+}
+
+inline Ptr<Application>
+LteQuicTcpScenario::GetSource(uint32_t flow) const
+{
+    return m_sources.at(flow);
+}
+
+inline Ptr<PacketSink>
+LteQuicTcpScenario::GetSink(uint32_t flow) const
+{
+    return m_sinks.at(flow);
+}
+
+inline uint64_t
+LteQuicTcpScenario::GetReceivedBytes(uint32_t flow) const
+{
+    return m_receivedBytes.at(flow);
+}
+
+inline double
+LteQuicTcpScenario::GetThroughput(uint32_t flow) const
+{
+    return (GetReceivedBytes(flow) * 8.0) / (m_duration * 1000 * 1000); // In Mbps
+}
+
+inline double
+LteQuicTcpScenario::GetThroughputSinceStart(uint32_t flow) const
+{
+    double start = GetStartTime(flow);
+    if (start < 0 || start >= m_duration)
+    {
+        return 0;
+    }
+    return (GetReceivedBytes(flow) * 8.0) / ((m_duration - start) * 1000 * 1000); // In Mbps
+}
+
+inline double
+LteQuicTcpScenario::GetStreamThroughput(uint32_t flow, uint32_t streamId) const
+{
+    NS_ABORT_MSG_IF(m_streamBytes.at(flow).empty(), "Flow " << flow << " has no streams");
+    NS_ABORT_MSG_IF(streamId == 0 || streamId > m_streamBytes[flow].size(),
+                    "Flow " << flow << " has no stream " << streamId);
+    double start = GetStartTime(flow);
+    if (start < 0 || start >= m_duration)
+    {
+        return 0;
+    }
+    return (m_streamBytes[flow][streamId - 1] * 8.0) / ((m_duration - start) * 1000 * 1000); // In Mbps
+}
+
+inline FairnessSample
+LteQuicTcpScenario::GetFairness() const
+{
+    std::vector<uint32_t> flows;
+    std::vector<double> throughputs;
+    for (uint32_t flow = 0; flow < m_config.flows.size(); ++flow)
+    {
+        if (GetStartTime(flow) >= 0)
+        {
+            flows.push_back(flow);
+            throughputs.push_back(GetThroughputSinceStart(flow));
+        }
+    }
+    return GetFairness(0, flows, throughputs);
+}
+
+inline std::vector<FairnessSample>
+LteQuicTcpScenario::GetFairnessTimeSeries(double window) const
+{
+    std::vector<FairnessSample> series;
+    if (m_samplers.empty())
+    {
+        return series;
+    }
+    // The running sums of the throughput samples of every flow, so that every window is O(flows):
+    std::vector<std::vector<double>> sums(m_samplers.size());
+    std::vector<double> times;
+    for (uint32_t flow = 0; flow < m_samplers.size(); ++flow)
+    {
+        std::vector<ThroughputSample> samples = GetTimeSeries(flow);
+        sums[flow].assign(samples.size() + 1, 0);
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            sums[flow][i + 1] = sums[flow][i] + samples[i].throughput;
+        }
+        if (flow == 0)
+        {
+            for (const ThroughputSample& sample : samples)
+            {
+                times.push_back(sample.time);
+            }
+        }
+    }
+    size_t windowSamples = std::max<size_t>(1, std::lround(window / m_config.samplingInterval));
+    std::vector<uint32_t> flows;
+    std::vector<double> throughputs;
+    for (size_t first = 0; first + windowSamples <= times.size(); ++first)
+    {
+        flows.clear();
+        throughputs.clear();
+        for (uint32_t flow = 0; flow < m_samplers.size(); ++flow)
+        {
+            double start = GetStartTime(flow);
+            if (start >= 0 && start <= times[first] + 1e-9)
+            {
+                flows.push_back(flow);
+                throughputs.push_back((sums[flow][first + windowSamples] - sums[flow][first]) / windowSamples);
+            }
+        }
+        series.push_back(GetFairness(times[first], flows, throughputs));
+    }
+    return series;
+}
+
+inline FairnessSample
+LteQuicTcpScenario::GetFairness(double time,
+                                const std::vector<uint32_t>& flows,
+                                const std::vector<double>& throughputs) const
+{
+    RunningStatistics tcp;
+    RunningStatistics quic;
+    for (size_t i = 0; i < flows.size(); ++i)
+    {
+        TransportProtocol protocol = m_config.remoteHosts[m_config.flows[flows[i]].remoteHost];
+        (protocol == TransportProtocol::QUIC ? quic : tcp).Add(throughputs[i]);
+    }
+    double shareRatio = std::numeric_limits<double>::quiet_NaN();
+    if (tcp.GetCount() > 0 && quic.GetCount() > 0 && tcp.GetMean() > 0)
+    {
+        shareRatio = quic.GetMean() / tcp.GetMean();
+    }
+    return {time, JainFairnessIndex(throughputs), shareRatio};
+}
+
+inline std::vector<ThroughputSample>
+LteQuicTcpScenario::GetTimeSeries(uint32_t flow) const
+{
+    return m_samplers.at(flow)->GetTimeSeries(Seconds(m_duration));
+}
+
+inline SteadyStateThroughput
+LteQuicTcpScenario::GetSteadyStateThroughput(uint32_t flow) const
+{
+    return m_samplers.at(flow)->GetSteadyState(Seconds(m_duration));
+}
+
+} // namespace ns3
+
+#endif /* LTE_QUIC_TCP_SCENARIO_H */
@@ -0,0 +1,224 @@
+#ifndef LTE_TRACE_SINK_H
+#define LTE_TRACE_SINK_H
+
+#include "ns3/core-module.h"
+#include "ns3/lte-module.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Buffered binary sinks for the per-TTI LTE traces.
+ *
+ * lteHelper->EnableTraces() formats a line of text (and looks up the IMSI of the RNTI) for every scheduling
+ * decision of every TTI. The sinks below write fixed-size records into a memory buffer instead, and the
+ * buffer is written to the file only when it is full. A file starts with an 8-byte magic, followed by
+ * the records in native byte order:
+ *
+ *   <prefix>DlMacStats-<run>.bin  "LTEDLMAC" + LteDlMacTraceRecord[]
+ *   <prefix>UlMacStats-<run>.bin  "LTEULMAC" + LteUlMacTraceRecord[]
+ *
+ * The prefix (--tracePrefix) keeps apart the files of processes run from the same directory, see GetTraceFileName.
+ */
+
+namespace ns3
+{
+
+struct LteDlMacTraceRecord
+{
+    double time; // In seconds.
+    uint32_t frameNo;
+    uint32_t subframeNo;
+    uint16_t cellId;
+    uint16_t rnti;
+    uint16_t sizeTb1; // In bytes.
+    uint16_t sizeTb2;
+    uint8_t mcsTb1;
+    uint8_t mcsTb2;
+    uint8_t componentCarrierId;
+    uint8_t reserved[5];
+};
+
+static_assert(sizeof(LteDlMacTraceRecord) == 32, "LteDlMacTraceRecord must have no hidden padding");
+
+struct LteUlMacTraceRecord
+{
+    double time; // In seconds.
+    uint32_t frameNo;
+    uint32_t subframeNo;
+    uint16_t cellId;
+    uint16_t rnti;
+    uint16_t size; // In bytes.
+    uint8_t mcs;
+    uint8_t componentCarrierId;
+};
+
+static_assert(sizeof(LteUlMacTraceRecord) == 24, "LteUlMacTraceRecord must have no hidden padding");
+
+/**
+ * The name of a binary trace file: <prefix><name>-<run>.bin, or <prefix><name>-<run>-<rank>.bin for the file of
+ * a rank of a distributed simulation. The run tells apart the replications of a process, the prefix (a directory
+ * ending in '/', or a name unique to the process) the processes that run at the same time, e.g. the jobs of a sweep.
+ */
+inline std::string
+GetTraceFileName(const std::string& prefix, const std::string& name, uint64_t run, int32_t rank = -1)
+{
+    std::string filename = prefix + name + "-" + std::to_string(run);
+    if (rank >= 0)
+    {
+        filename += "-" + std::to_string(rank);
+    }
+    return filename + ".bin";
+}
+
+/**
+ * A file of fixed-size records, written through a memory buffer.
+ */
+class BinaryTraceFile
+{
+  public:
+    BinaryTraceFile(const std::string& filename, const char (&magic)[9], size_t bufferSize = 1 << 20)
+        : m_buffer(bufferSize)
+    {
+        m_file = std::fopen(filename.c_str(), "wb");
+        NS_ABORT_MSG_IF(m_file == nullptr, "Cannot open the trace file " << filename);
+        std::fwrite(magic, 1, 8, m_file);
+    }
+
+    ~BinaryTraceFile()
+    {
+        Flush();
+        std::fclose(m_file);
+    }
+
+    BinaryTraceFile(const BinaryTraceFile&) = delete;
+    BinaryTraceFile& operator=(const BinaryTraceFile&) = delete;
+
+    template <class Record>
+    void Write(const Record& record)
+    {
+        if (m_used + sizeof(Record) > m_buffer.size())
+        {
+            Flush();
+        }
+        std::memcpy(m_buffer.data() + m_used, &record, sizeof(Record));
+        m_used += sizeof(Record);
+    }
+
+    void Flush()
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::fwrite(m_buffer.data(), 1, m_used, m_file);
+        std::fflush(m_file);
+        m_used = 0;
+        m_writeTime += std::chrono::steady_clock::now() - start;
+    }
+
+    /**
+     * The wall time spent writing to the file, in seconds.
+     */
+    double GetWriteTime() const
+    {
+        return m_writeTime.count();
+    }
+
+  private:
+    std::FILE* m_file;
+    std::vector<char> m_buffer;
+    size_t m_used = 0;
+    std::chrono::duration<double> m_writeTime{0};
+};
+
+/**
+ * Records the DL and UL scheduling decisions of the MAC of every eNB.
+ */
+class LteMacTraceSink
+{
+  public:
+    LteMacTraceSink(const std::string& prefix, uint64_t run)
+        : m_dlFile(GetTraceFileName(prefix, "DlMacStats", run), "LTEDLMAC"),
+          m_ulFile(GetTraceFileName(prefix, "UlMacStats", run), "LTEULMAC")
+    {
+    }
+
+    /**
+     * Connect the sink to the MAC of the eNBs. The cell ID is bound to the callbacks,
+     * so that no context string has to be parsed on every TTI.
+     */
+    void Connect(const NetDeviceContainer& enbLteDevs)
+    {
+        for (uint32_t i = 0; i < enbLteDevs.GetN(); ++i)
+        {
+            Ptr<LteEnbNetDevice> enbDev = enbLteDevs.Get(i)->GetObject<LteEnbNetDevice>();
+            std::string macPath = "/NodeList/" + std::to_string(enbDev->GetNode()->GetId()) + "/DeviceList/" +
+                                  std::to_string(enbDev->GetIfIndex()) + "/ComponentCarrierMap/*/LteEnbMac/";
+            Config::ConnectWithoutContext(macPath + "DlScheduling",
+                                          MakeBoundCallback(&LteMacTraceSink::DlScheduling, this, enbDev->GetCellId()));
+            Config::ConnectWithoutContext(macPath + "UlScheduling",
+                                          MakeBoundCallback(&LteMacTraceSink::UlScheduling, this, enbDev->GetCellId()));
+        }
+    }
+
+    void Flush()
+    {
+        m_dlFile.Flush();
+        m_ulFile.Flush();
+    }
+
+    /**
+     * The wall time spent writing the traces, in seconds.
+     */
+    double GetWriteTime() const
+    {
+        return m_dlFile.GetWriteTime() + m_ulFile.GetWriteTime();
+    }
+
+  private:
+    static void DlScheduling(LteMacTraceSink* sink, uint16_t cellId, DlSchedulingCallbackInfo info)
+    {
+        LteDlMacTraceRecord record = {};
+        record.time = Simulator::Now().GetSeconds();
+        record.frameNo = info.frameNo;
+        record.subframeNo = info.subframeNo;
+        record.cellId = cellId;
+        record.rnti = info.rnti;
+        record.sizeTb1 = info.sizeTb1;
+        record.sizeTb2 = info.sizeTb2;
+        record.mcsTb1 = info.mcsTb1;
+        record.mcsTb2 = info.mcsTb2;
+        record.componentCarrierId = info.componentCarrierId;
+        sink->m_dlFile.Write(record);
+    }
+
+    static void UlScheduling(LteMacTraceSink* sink,
+                             uint16_t cellId,
+                             uint32_t frameNo,
+                             uint32_t subframeNo,
+                             uint16_t rnti,
+                             uint8_t mcs,
+                             uint16_t size,
+                             uint8_t componentCarrierId)
+    {
+        LteUlMacTraceRecord record = {};
+        record.time = Simulator::Now().GetSeconds();
+        record.frameNo = frameNo;
+        record.subframeNo = subframeNo;
+        record.cellId = cellId;
+        record.rnti = rnti;
+        record.size = size;
+        record.mcs = mcs;
+        record.componentCarrierId = componentCarrierId;
+        sink->m_ulFile.Write(record);
+    }
+
+    BinaryTraceFile m_dlFile;
+    BinaryTraceFile m_ulFile;
+};
+
+} // namespace ns3
+
+#endif /* LTE_TRACE_SINK_H */
@@ -0,0 +1,301 @@
+#ifndef QUIC_STREAM_APPLICATION_H
+#define QUIC_STREAM_APPLICATION_H
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/quic-module.h"
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * A bulk sender that multiplexes its data over several streams of one QUIC connection.
+ *
+ * The sender writes SendSize chunks to streams 1..Streams in turn (QuicSocketBase::Send takes the stream ID as its
+ * flags). Every chunk carries a QuicStreamTag byte tag with the ID of its flow and of its stream, and the time it
+ * was written, which follows its bytes through the QUIC frames and the LTE segmentation down to the PacketSink of
+ * the UE. There, the bytes of every stream, and of every connection when several connections share the sink, are
+ * told apart by their tags, and the delay of every chunk is the time since it was written.
+ *
+ * With a TCP Protocol, it is a BulkSendApplication whose data carries the same tags (on stream 1).
+ * Either way, it can set its own CongestionControl on its socket.
+ */
+
+namespace ns3
+{
+
+/**
+ * The flow and the QUIC stream the tagged bytes were sent on.
+ */
+class QuicStreamTag : public Tag
+{
+  public:
+    QuicStreamTag(uint32_t flowId = 0, uint32_t streamId = 0, Time sendTime = Time())
+        : m_flowId(flowId),
+          m_streamId(streamId),
+          m_sendTime(sendTime.GetInteger())
+    {
+    }
+
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::QuicStreamTag")
+                                .SetParent<Tag>()
+                                .SetGroupName("Applications")
+                                .AddConstructor<QuicStreamTag>();
+        return tid;
+    }
+
+    TypeId GetInstanceTypeId() const override
+    {
+        return GetTypeId();
+    }
+
+    uint32_t GetSerializedSize() const override
+    {
+        return 16;
+    }
+
+    void Serialize(TagBuffer buffer) const override
+    {
+        buffer.WriteU32(m_flowId);
+        buffer.WriteU32(m_streamId);
+        buffer.WriteU64(m_sendTime);
+    }
+
+    void Deserialize(TagBuffer buffer) override
+    {
+        m_flowId = buffer.ReadU32();
+        m_streamId = buffer.ReadU32();
+        m_sendTime = buffer.ReadU64();
+    }
+
+    void Print(std::ostream& os) const override
+    {
+        os << "flow=" << m_flowId << " stream=" << m_streamId << " sendTime=" << GetSendTime();
+    }
+
+    uint32_t GetFlowId() const
+    {
+        return m_flowId;
+    }
+
+    uint32_t GetStreamId() const
+    {
+        return m_streamId;
+    }
+
+    /**
+     * When the tagged bytes were written to the socket.
+     */
+    Time GetSendTime() const
+    {
+        return TimeStep(m_sendTime);
+    }
+
+  private:
+    uint32_t m_flowId;
+    uint32_t m_streamId;
+    uint64_t m_sendTime; // In time steps.
+};
+
+// In a header, the registration runs once per translation unit that includes it, which is harmless: it only calls
+// GetTypeId(), an inline function whose TypeId is a single static, so the type is registered once. (Each program of
+// Simulations/ is a single translation unit anyway.)
+NS_OBJECT_ENSURE_REGISTERED(QuicStreamTag);
+
+/**
+ * Sends data as fast as the QUIC socket takes it, over Streams streams of one connection.
+ * Mirrors BulkSendApplication, with the stream of every chunk chosen round-robin.
+ */
+class QuicStreamSendApplication : public Application
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid =
+            TypeId("ns3::QuicStreamSendApplication")
+                .SetParent<Application>()
+                .SetGroupName("Applications")
+                .AddConstructor<QuicStreamSendApplication>()
+                .AddAttribute("Remote",
+                              "The address of the destination",
+                              AddressValue(),
+                              MakeAddressAccessor(&QuicStreamSendApplication::m_peer),
+                              MakeAddressChecker())
+                .AddAttribute("Protocol",
+                              "The socket factory of the connection: QUIC, or TCP with a single stream",
+                              TypeIdValue(QuicSocketFactory::GetTypeId()),
+                              MakeTypeIdAccessor(&QuicStreamSendApplication::m_protocol),
+                              MakeTypeIdChecker())
+                .AddAttribute("CongestionControl",
+                              "The TcpCongestionOps of the socket (the default of the protocol if unset)",
+                              TypeIdValue(TcpCongestionOps::GetTypeId()),
+                              MakeTypeIdAccessor(&QuicStreamSendApplication::m_congestionControl),
+                              MakeTypeIdChecker())
+                .AddAttribute("SendSize",
+                              "The amount of data written to a stream at once",
+                              UintegerValue(512),
+                              MakeUintegerAccessor(&QuicStreamSendApplication::m_sendSize),
+                              MakeUintegerChecker<uint32_t>(1))
+                .AddAttribute("Streams",
+                              "The number of streams the data is spread over",
+                              UintegerValue(1),
+                              MakeUintegerAccessor(&QuicStreamSendApplication::m_streams),
+                              MakeUintegerChecker<uint32_t>(1))
+                .AddAttribute("FlowId",
+                              "The flow ID written in the tags of the data",
+                              UintegerValue(0),
+                              MakeUintegerAccessor(&QuicStreamSendApplication::m_flowId),
+                              MakeUintegerChecker<uint32_t>())
+                .AddAttribute("MaxBytes",
+                              "The total number of bytes to send (zero is unlimited)",
+                              UintegerValue(0),
+                              MakeUintegerAccessor(&QuicStreamSendApplication::m_maxBytes),
+                              MakeUintegerChecker<uint64_t>());
+        return tid;
+    }
+
+    uint64_t GetTotalBytes() const
+    {
+        return m_totalBytes;
+    }
+
+    /**
+     * The socket of the connection, once the application started.
+     */
+    Ptr<Socket> GetSocket() const
+    {
+        return m_socket;
+    }
+
+  protected:
+    void DoDispose() override
+    {
+        m_socket = nullptr;
+        Application::DoDispose();
+    }
+
+  private:
+    void StartApplication() override
+    {
+        if (!m_socket)
+        {
+            bool quic = m_protocol == QuicSocketFactory::GetTypeId();
+            NS_ABORT_MSG_IF(!quic && m_streams > 1, "Only QUIC connections have several streams");
+            m_socket = Socket::CreateSocket(GetNode(), m_protocol);
+            NS_ABORT_MSG_IF(m_socket->Bind() == -1, "Failed to bind the socket");
+            m_streamFlags = quic;
+            if (m_congestionControl != TcpCongestionOps::GetTypeId())
+            {
+                ObjectFactory factory;
+                factory.SetTypeId(m_congestionControl);
+                Ptr<TcpCongestionOps> congestionControl = factory.Create<TcpCongestionOps>();
+                if (quic)
+                {
+                    DynamicCast<QuicSocketBase>(m_socket)->SetCongestionControlAlgorithm(congestionControl);
+                }
+                else
+                {
+                    DynamicCast<TcpSocketBase>(m_socket)->SetCongestionControlAlgorithm(congestionControl);
+                }
+            }
+            m_socket->Connect(m_peer);
+            m_socket->ShutdownRecv();
+            m_socket->SetConnectCallback(MakeCallback(&QuicStreamSendApplication::ConnectionSucceeded, this),
+                                         MakeCallback(&QuicStreamSendApplication::ConnectionFailed, this));
+            m_socket->SetSendCallback(MakeCallback(&QuicStreamSendApplication::DataSend, this));
+        }
+        if (m_connected)
+        {
+            SendData();
+        }
+    }
+
+    void StopApplication() override
+    {
+        if (m_socket)
+        {
+            m_socket->Close();
+            m_connected = false;
+        }
+    }
+
+    void SendData()
+    {
+        if (m_sending)
+        {
+            return; // A DataSend() from within Send(): the loop below goes on anyway.
+        }
+        m_sending = true;
+        while (m_maxBytes == 0 || m_totalBytes < m_maxBytes)
+        {
+            uint64_t toSend = m_sendSize;
+            if (m_maxBytes > 0)
+            {
+                toSend = std::min(toSend, m_maxBytes - m_totalBytes);
+            }
+            if (m_socket->GetTxAvailable() < toSend)
+            {
+                break; // DataSend() resumes when there is room again.
+            }
+            // Stream 0 is left to the connection itself, the data goes to streams 1..m_streams:
+            uint32_t streamId = m_nextStream + 1;
+            Ptr<Packet> packet = Create<Packet>(toSend);
+            packet->AddByteTag(QuicStreamTag(m_flowId, streamId, Simulator::Now()));
+            int actual = m_socket->Send(packet, m_streamFlags ? streamId : 0);
+            if (actual <= 0)
+            {
+                break;
+            }
+            m_totalBytes += actual;
+            m_nextStream = (m_nextStream + 1) % m_streams;
+        }
+        m_sending = false;
+        if (m_maxBytes > 0 && m_totalBytes == m_maxBytes && m_connected)
+        {
+            m_socket->Close();
+            m_connected = false;
+        }
+    }
+
+    void ConnectionSucceeded(Ptr<Socket>)
+    {
+        m_connected = true;
+        SendData();
+    }
+
+    void ConnectionFailed(Ptr<Socket>)
+    {
+        NS_ABORT_MSG("The connection of the stream sender failed");
+    }
+
+    void DataSend(Ptr<Socket>, uint32_t)
+    {
+        if (m_connected)
+        {
+            SendData(); // Directly, like BulkSend: no event per callback.
+        }
+    }
+
+    Ptr<Socket> m_socket;
+    TypeId m_protocol;
+    TypeId m_congestionControl;
+    bool m_streamFlags = true; // Whether Send takes the stream ID as its flags (QUIC).
+    Address m_peer;
+    bool m_connected = false;
+    bool m_sending = false; // Within SendData().
+    uint32_t m_sendSize = 512;
+    uint32_t m_streams = 1;
+    uint32_t m_flowId = 0;
+    uint64_t m_maxBytes = 0;
+    uint64_t m_totalBytes = 0;
+    uint32_t m_nextStream = 0; // Zero-based; the stream ID is one more.
+};
+
+NS_OBJECT_ENSURE_REGISTERED(QuicStreamSendApplication);
+
+} // namespace ns3
+
+#endif /* QUIC_STREAM_APPLICATION_H */
@@ -0,0 +1,351 @@
+#ifndef REPLICATION_RUNNER_H
+#define REPLICATION_RUNNER_H
+
+#include "kpi-statistics.h"
+#include "kpi-table.h"
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#ifdef NS3_MPI
+#include "ns3/mpi-module.h"
+#endif
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Runs several replications of a simulation in one process, instead of paying the ns-3 startup
+ * for every replication, and each replication builds its own scenario:
+ *
+ *   ReplicationRunner runner;
+ *   runner.AddCommandLineValues(cmd); // --replications, --seed, --run, --job, --results
+ *   cmd.Parse(argc, argv);
+ *   runner.SetParameter("distance", distance);
+ *   ...
+ *   return runner.Run([&](ReplicationKpis& kpis) {
+ *       LteQuicTcpScenario scenario(config);
+ *       scenario.Build();
+ *       scenario.Run();
+ *       kpis.Add("throughput", scenario.GetThroughput(0));
+ *       kpis.Record("flow0Bytes", scenario.GetReceivedBytes(0));
+ *       Simulator::Destroy();
+ *       return true;
+ *   });
+ *
+ * Seeding is deterministic: the seed and the run numbers only come from the command line, so any
+ * replication can be reproduced with --seed=<seed> --run=<run> --replications=1. Replication i of job j
+ * uses the run number
+ *
+ *   run + j * replications + i
+ *
+ * so that parallel jobs of the same sweep (--job=0, 1, 2, ...) never share a run number. Different run
+ * numbers of the same seed select disjoint substreams of the MRG32k3a generator, which makes all the
+ * replications of a sweep statistically independent.
+ *
+ * With --results=<file>, the process appends one row per successful replication to a KPI table
+ * (see kpi-table.h): the program and its parameters, the seed and the run number, and the KPIs.
+ * Utils/Tools/kpi-reader.cc prints and summarizes the tables.
+ *
+ * When ns-3 is built with MPI, --distributed runs the replication as a distributed simulation over the ranks
+ * of mpiexec (see lte-quic-tcp-scenario.h for the partition), one replication per process. All the ranks run
+ * it, but only rank 0 prints (to std::cout and std::clog) and writes the results.
+ */
+
+namespace ns3
+{
+
+/**
+ * The KPIs of one replication, in the order they were added.
+ *
+ * A replication that measures several things in one simulation (e.g. the downloads of several file sizes)
+ * starts a row for each of them with AddRow(), and tells them apart with row parameters.
+ */
+class ReplicationKpis
+{
+  public:
+    struct Row
+    {
+        std::vector<std::pair<std::string, std::string>> parameters;
+        std::vector<std::pair<std::string, double>> values;
+        std::vector<std::pair<std::string, double>> records;
+    };
+
+    ReplicationKpis()
+        : m_rows(1)
+    {
+    }
+
+    /**
+     * Start a new row: the next parameters, KPIs and records go to it.
+     */
+    void AddRow()
+    {
+        m_rows.emplace_back();
+    }
+
+    /**
+     * Set a parameter of the current row, which overrides the parameter of the program with the same name.
+     */
+    void SetParameter(const std::string& name, const std::string& value)
+    {
+        m_rows.back().parameters.emplace_back(name, value);
+    }
+
+    /**
+     * Add a KPI, which is averaged over the replications and written to the results.
+     */
+    void Add(const std::string& name, double value)
+    {
+        m_rows.back().values.emplace_back(name, value);
+    }
+
+    /**
+     * Add a value that is only written to the results (per-flow bytes, ...).
+     */
+    void Record(const std::string& name, double value)
+    {
+        m_rows.back().records.emplace_back(name, value);
+    }
+
+    /**
+     * Record several values at once (e.g. a SimulationProfile).
+     */
+    void Record(const std::vector<std::pair<std::string, double>>& values)
+    {
+        for (const auto& [name, value] : values)
+        {
+            Record(name, value);
+        }
+    }
+
+    const std::vector<Row>& GetRows() const
+    {
+        return m_rows;
+    }
+
+  private:
+    std::vector<Row> m_rows;
+};
+
+class ReplicationRunner
+{
+  public:
+    /**
+     * A replication builds, runs and destroys one simulation, prints its per-run results and adds its KPIs.
+     * It returns false if the run failed; failed runs are left out of the aggregate.
+     */
+    using Replication = std::function<bool(ReplicationKpis& kpis)>;
+
+    /**
+     * Add the options of the runner to the command line of the program.
+     */
+    void AddCommandLineValues(CommandLine& cmd)
+    {
+        m_program = cmd.GetName();
+        cmd.AddValue("replications", "Number of replications to run in this process", m_replications);
+        cmd.AddValue("seed", "The RNG seed", m_seed);
+        cmd.AddValue("run", "The RNG run number of the first replication of the first job", m_run);
+        cmd.AddValue("job", "The index of this process in a parallel sweep; shifts the run numbers by job * replications",
+                     m_job);
+        cmd.AddValue("results", "A KPI table file to append a row to for every replication (read it with kpi-reader)",
+                     m_resultsFile);
+#ifdef NS3_MPI
+        cmd.AddValue("distributed", "Run a distributed simulation over the MPI ranks (one replication)", m_distributed);
+#endif
+    }
+
+    /**
+     * Set a scenario parameter, written to the results with every replication.
+     */
+    void SetParameter(const std::string& name, const std::string& value)
+    {
+        if (m_parameters.GetRows() == 0)
+        {
+            m_parameters.AddRow();
+        }
+        m_parameters.Set(0, name, KpiColumnRole::PARAMETER, value);
+    }
+
+    void SetParameter(const std::string& name, double value)
+    {
+        if (m_parameters.GetRows() == 0)
+        {
+            m_parameters.AddRow();
+        }
+        m_parameters.Set(0, name, KpiColumnRole::PARAMETER, value);
+    }
+
+    /**
+     * Set several scenario parameters, e.g. LteQuicTcpScenarioConfig::GetParameters().
+     */
+    void SetParameters(const std::vector<std::pair<std::string, std::string>>& parameters)
+    {
+        for (const auto& [name, value] : parameters)
+        {
+            SetParameter(name, value);
+        }
+    }
+
+    /**
+     * Run all the replications. When there is more than one, print an aggregate line per KPI:
+     *   AVERAGE <kpi>: <mean> STDDEV: <std. dev.> CI95: <half-width> N: <successful runs> SEED: <seed> RUNS: <first>-<last>
+     * The KPIs of rows with parameters are aggregated per value of the parameters, e.g. 'dlt[fileSize=1MB]'.
+     * Returns the exit code of the program: 0, or -1 if any replication failed.
+     */
+    int Run(const Replication& replication)
+    {
+        NS_ABORT_MSG_IF(m_replications == 0, "At least one replication is needed");
+        NS_ABORT_MSG_IF(m_seed == 0, "The RNG seed must not be zero");
+        RngSeedManager::SetSeed(m_seed);
+        uint64_t firstRun = GetFirstRun();
+#ifdef NS3_MPI
+        if (m_distributed)
+        {
+            NS_ABORT_MSG_IF(m_replications > 1, "A distributed simulation runs one replication per process");
+            GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DistributedSimulatorImpl"));
+            MpiInterface::Enable(nullptr, nullptr);
+        }
+        // The other ranks only simulate their part, their results (on std::cout) and their profile and latencies
+        // (on std::clog) are discarded. std::cerr is kept for the aborts:
+        std::streambuf* coutBuffer = std::cout.rdbuf();
+        std::streambuf* clogBuffer = std::clog.rdbuf();
+        bool mainRank = !m_distributed || MpiInterface::GetSystemId() == 0;
+        if (!mainRank)
+        {
+            std::cout.rdbuf(nullptr);
+            std::clog.rdbuf(nullptr);
+        }
+#else
+        bool mainRank = true;
+#endif
+
+        KpiTable results;
+        uint32_t failed = 0;
+        for (uint32_t i = 0; i < m_replications; ++i)
+        {
+            // Every replication starts from a clean slate, as if it was a new process:
+            RngSeedManager::SetRun(firstRun + i);
+            RngSeedManager::ResetNextStreamIndex();
+            Ipv4AddressGenerator::Reset();
+
+            ReplicationKpis kpis;
+            if (!replication(kpis))
+            {
+                ++failed;
+                continue;
+            }
+            for (const ReplicationKpis::Row& kpisRow : kpis.GetRows())
+            {
+                size_t row = results.AddRow();
+                results.Set(row, "program", KpiColumnRole::PARAMETER, m_program);
+                for (const KpiColumn& parameter : m_parameters.GetColumns())
+                {
+                    if (parameter.type == KpiColumnType::STRING)
+                    {
+                        results.Set(row, parameter.name, parameter.role, parameter.strings[0]);
+                    }
+                    else
+                    {
+                        results.Set(row, parameter.name, parameter.role, parameter.GetDouble(0));
+                    }
+                }
+                std::string rowName; // The row parameters, appended to the names of the aggregated KPIs.
+                for (const auto& [name, value] : kpisRow.parameters)
+                {
+                    results.Set(row, name, KpiColumnRole::PARAMETER, value);
+                    rowName += (rowName.empty() ? "[" : ",") + name + "=" + value;
+                }
+                rowName += rowName.empty() ? "" : "]";
+                results.Set(row, "seed", KpiColumnRole::ID, static_cast<int64_t>(m_seed));
+                results.Set(row, "run", KpiColumnRole::ID, static_cast<int64_t>(firstRun + i));
+                for (const auto& [name, value] : kpisRow.values)
+                {
+                    GetStatistics(name + rowName).Add(value);
+                    results.Set(row, name, KpiColumnRole::KPI, value);
+                }
+                for (const auto& [name, value] : kpisRow.records)
+                {
+                    results.Set(row, name, KpiColumnRole::KPI, value);
+                }
+            }
+        }
+
+        // All the rows of the process go to the file as one row group:
+        if (!m_resultsFile.empty() && mainRank)
+        {
+            try
+            {
+                results.AppendTo(m_resultsFile);
+            }
+            catch (const std::exception& e)
+            {
+                NS_ABORT_MSG(e.what());
+            }
+        }
+
+        if (m_replications > 1)
+        {
+            for (const auto& [name, statistics] : m_statistics)
+            {
+                std::cout << "AVERAGE " << name << ": " << statistics.GetMean()
+                          << " STDDEV: " << statistics.GetStdDev()
+                          << " CI95: " << statistics.GetConfidenceInterval95()
+                          << " N: " << statistics.GetCount() << " SEED: " << m_seed
+                          << " RUNS: " << firstRun << '-' << firstRun + m_replications - 1 << std::endl;
+            }
+        }
+#ifdef NS3_MPI
+        if (m_distributed)
+        {
+            std::cout.rdbuf(coutBuffer);
+            std::clog.rdbuf(clogBuffer);
+            MpiInterface::Disable();
+        }
+#endif
+        return failed == 0 || !mainRank ? 0 : -1;
+    }
+
+    /**
+     * The run number of the first replication of this process.
+     */
+    uint64_t GetFirstRun() const
+    {
+        return m_run + static_cast<uint64_t>(m_job) * m_replications;
+    }
+
+    uint32_t GetSeed() const
+    {
+        return m_seed;
+    }
+
+  private:
+    RunningStatistics& GetStatistics(const std::string& name)
+    {
+        for (auto& [kpi, statistics] : m_statistics)
+        {
+            if (kpi == name)
+            {
+                return statistics;
+            }
+        }
+        m_statistics.emplace_back(name, RunningStatistics());
+        return m_statistics.back().second;
+    }
+
+    uint32_t m_replications = 1;
+    uint32_t m_seed = 1;
+    uint64_t m_run = 1;
+    uint32_t m_job = 0;
+    std::string m_resultsFile;
+    bool m_distributed = false;
+    std::string m_program;
+    KpiTable m_parameters; // A single row.
+    std::vector<std::pair<std::string, RunningStatistics>> m_statistics; // In the order of the first run.
+};
+
+} // namespace ns3
+
+#endif /* REPLICATION_RUNNER_H */
@@ -0,0 +1,167 @@
+#ifndef SENDER_PROBE_H
+#define SENDER_PROBE_H
+
+#include "lte-trace-sink.h"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+/**
+ * Probes of the congestion control state of the senders: their congestion window, bytes in flight and RTT.
+ *
+ * The probes connect to the CongestionWindow, BytesInFlight and RTT traces of the socket of every sender (TCP
+ * and QUIC sockets have traces of the same names), which only store the latest value. Every interval, one
+ * record per flow is appended to a buffer allocated for the whole simulation. So the per-ACK traces cost a
+ * store, not a line of text, and the records are written to a single binary file at the end of the run:
+ *
+ *   <prefix>SenderProbes-<run>[-<rank>].bin  "SNDPROBE" + SenderProbeRecord[]  (in native byte order, flow by flow)
+ *
+ * A value is zero until its trace first changes after the probe is connected, just after the sender starts.
+ * A trace the socket does not have stays at zero.
+ */
+
+namespace ns3
+{
+
+struct SenderProbeRecord
+{
+    double time;            // In seconds.
+    uint32_t flow;          // Index in LteQuicTcpScenarioConfig::flows.
+    uint32_t cwnd;          // The congestion window at the sample time, in bytes.
+    uint32_t minCwnd;       // The smallest congestion window since the previous sample: the reductions that
+                            // the window recovers from within an interval still show.
+    uint32_t bytesInFlight; // In bytes.
+    uint32_t rtt;           // The last RTT sample, in microseconds.
+    uint32_t reserved;
+};
+
+static_assert(sizeof(SenderProbeRecord) == 32, "SenderProbeRecord must have no hidden padding");
+
+class SenderProbe
+{
+  public:
+    /**
+     * \param flows the number of flows.
+     * \param interval the sampling interval.
+     * \param duration the duration of the simulation, which sizes the buffers.
+     */
+    SenderProbe(uint32_t flows, Time interval, Time duration)
+        : m_interval(interval),
+          m_flows(flows)
+    {
+        NS_ABORT_MSG_IF(!interval.IsPositive(), "The probe interval must be positive");
+        auto capacity = static_cast<size_t>(std::ceil(duration.GetSeconds() / interval.GetSeconds())) + 1;
+        for (FlowProbe& flow : m_flows)
+        {
+            flow.records.reserve(capacity);
+        }
+        Simulator::Schedule(m_interval, &SenderProbe::Sample, this);
+    }
+
+    SenderProbe(const SenderProbe&) = delete;
+    SenderProbe& operator=(const SenderProbe&) = delete;
+
+    /**
+     * Probe the socket of a flow, from now on.
+     */
+    void Connect(uint32_t flow, Ptr<Socket> socket)
+    {
+        FlowProbe& probe = m_flows.at(flow);
+        probe.connected = true;
+        bool connected =
+            socket->TraceConnectWithoutContext("CongestionWindow",
+                                               MakeBoundCallback(&SenderProbe::CwndChange, &probe)) &&
+            socket->TraceConnectWithoutContext("BytesInFlight",
+                                               MakeBoundCallback(&SenderProbe::BytesInFlightChange, &probe)) &&
+            socket->TraceConnectWithoutContext("RTT", MakeBoundCallback(&SenderProbe::RttChange, &probe));
+        NS_ABORT_MSG_IF(!connected,
+                        "The socket of flow " << flow << " (" << socket->GetInstanceTypeId().GetName()
+                                              << ") lacks the CongestionWindow, BytesInFlight or RTT trace");
+    }
+
+    const std::vector<SenderProbeRecord>& GetRecords(uint32_t flow) const
+    {
+        return m_flows.at(flow).records;
+    }
+
+    /**
+     * Write the records of all the flows to a file.
+     */
+    void Write(const std::string& filename)
+    {
+        BinaryTraceFile file(filename, "SNDPROBE");
+        for (const FlowProbe& flow : m_flows)
+        {
+            for (const SenderProbeRecord& record : flow.records)
+            {
+                file.Write(record);
+            }
+        }
+        file.Flush();
+        m_writeTime += file.GetWriteTime();
+    }
+
+    /**
+     * The wall time spent writing the records, in seconds.
+     */
+    double GetWriteTime() const
+    {
+        return m_writeTime;
+    }
+
+  private:
+    struct FlowProbe
+    {
+        bool connected = false;
+        uint32_t cwnd = 0;
+        uint32_t minCwnd = 0;
+        uint32_t bytesInFlight = 0;
+        uint32_t rtt = 0;
+        std::vector<SenderProbeRecord> records;
+    };
+
+    void Sample()
+    {
+        double now = Simulator::Now().GetSeconds();
+        for (uint32_t i = 0; i < m_flows.size(); ++i)
+        {
+            FlowProbe& flow = m_flows[i];
+            if (!flow.connected || flow.records.size() == flow.records.capacity())
+            {
+                continue; // Not started yet, or the simulation ran past its duration.
+            }
+            flow.records.push_back({now, i, flow.cwnd, flow.minCwnd, flow.bytesInFlight, flow.rtt, 0});
+            flow.minCwnd = flow.cwnd;
+        }
+        Simulator::Schedule(m_interval, &SenderProbe::Sample, this);
+    }
+
+    static void CwndChange(FlowProbe* flow, uint32_t, uint32_t newValue)
+    {
+        flow->minCwnd = flow->cwnd == 0 ? newValue : std::min(flow->minCwnd, newValue);
+        flow->cwnd = newValue;
+    }
+
+    static void BytesInFlightChange(FlowProbe* flow, uint32_t, uint32_t newValue)
+    {
+        flow->bytesInFlight = newValue;
+    }
+
+    static void RttChange(FlowProbe* flow, Time, Time newValue)
+    {
+        flow->rtt = static_cast<uint32_t>(newValue.GetMicroSeconds());
+    }
+
+    Time m_interval;
+    std::vector<FlowProbe> m_flows; // Never resized: the callbacks are bound to its elements.
+    double m_writeTime = 0;
+};
+
+} // namespace ns3
+
+#endif /* SENDER_PROBE_H */
@@ -0,0 +1,256 @@
+#ifndef SIMULATION_PROFILE_H
+#define SIMULATION_PROFILE_H
+
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <iostream>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Wall-clock profiling of a simulation (--profile): the wall time of its phases (building the topology,
+ * attaching the UEs, installing the flows, the event loop, ...), the number of events it executed, and
+ * the events per wall-clock second.
+ *
+ * With --profileEvents, the events are also counted per type. The simulator then uses an
+ * EventProfilingScheduler, which counts every event it hands out by the C++ type of its EventImpl: the
+ * type of an event made by Simulator::Schedule names the class the event calls into (LteEnbPhy, TcpSocketBase,
+ * QuicSocketBase, ...), which gives the subsystem of the event. Counting costs a hash lookup per event, so
+ * it is off by default.
+ */
+
+namespace ns3
+{
+
+/**
+ * A MapScheduler that counts the events it hands out to the simulator, by type.
+ */
+class EventProfilingScheduler : public MapScheduler
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::EventProfilingScheduler")
+                                .SetParent<MapScheduler>()
+                                .SetGroupName("Core")
+                                .AddConstructor<EventProfilingScheduler>();
+        return tid;
+    }
+
+    Event RemoveNext() override
+    {
+        Event event = MapScheduler::RemoveNext();
+        if (!event.impl->IsCancelled())
+        {
+            ++GetCounts()[std::type_index(typeid(*event.impl))];
+        }
+        return event;
+    }
+
+    /**
+     * The events executed since the last Reset(), by type.
+     */
+    static std::unordered_map<std::type_index, uint64_t>& GetCounts()
+    {
+        static std::unordered_map<std::type_index, uint64_t> counts;
+        return counts;
+    }
+
+    static void Reset()
+    {
+        GetCounts().clear();
+    }
+};
+
+NS_OBJECT_ENSURE_REGISTERED(EventProfilingScheduler);
+
+/**
+ * The subsystem an event type belongs to, from the classes its name mentions.
+ */
+inline std::string
+GetEventCategory(const std::type_index& type)
+{
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+    std::string name = status == 0 ? demangled : type.name();
+    std::free(demangled);
+
+    auto has = [&name](const char* part) { return name.find(part) != std::string::npos; };
+    if (has("Quic"))
+    {
+        return "Quic";
+    }
+    if (has("Tcp"))
+    {
+        return "Tcp";
+    }
+    if (has("Spectrum") || has("LteEnbPhy") || has("LteUePhy") || has("LtePhy"))
+    {
+        return "LtePhy";
+    }
+    if (has("LteEnbMac") || has("LteUeMac") || has("FfMac") || has("LteMac"))
+    {
+        return "LteMac";
+    }
+    if (has("LteRlc") || has("LtePdcp"))
+    {
+        return "LteRlcPdcp";
+    }
+    if (has("Rrc"))
+    {
+        return "LteRrc";
+    }
+    if (has("Epc") || has("GtpU"))
+    {
+        return "Epc";
+    }
+    if (has("PointToPoint"))
+    {
+        return "PointToPoint";
+    }
+    if (has("Ipv4") || has("Udp") || has("Arp"))
+    {
+        return "Ip";
+    }
+    if (has("Application") || has("PacketSink"))
+    {
+        return "Applications";
+    }
+    return "Other";
+}
+
+/**
+ * The wall time of the phases of a simulation, and its event counts.
+ */
+class SimulationProfile
+{
+  public:
+    /**
+     * End the current phase, if any, and start the given one.
+     */
+    void StartPhase(const std::string& phase)
+    {
+        StopPhase();
+        m_phase = phase;
+        m_phaseStart = std::chrono::steady_clock::now();
+    }
+
+    void StopPhase()
+    {
+        if (!m_phase.empty())
+        {
+            std::chrono::duration<double> wallTime = std::chrono::steady_clock::now() - m_phaseStart;
+            AddPhase(m_phase, wallTime.count());
+            m_phase.clear();
+        }
+    }
+
+    /**
+     * Add the wall time of a phase measured elsewhere, in seconds.
+     */
+    void AddPhase(const std::string& phase, double wallTime)
+    {
+        m_phases.emplace_back(phase, wallTime);
+    }
+
+    /**
+     * Set the events of the event loop, which ran for the given wall time and simulated time, in seconds.
+     */
+    void SetEvents(uint64_t events, double wallTime, double simulatedTime)
+    {
+        m_events = events;
+        m_runWallTime = wallTime;
+        m_simulatedTime = simulatedTime;
+    }
+
+    /**
+     * Take the counts of the EventProfilingScheduler, by category.
+     */
+    void SetEventTypes(const std::unordered_map<std::type_index, uint64_t>& counts)
+    {
+        m_eventTypes.clear();
+        for (const auto& [type, count] : counts)
+        {
+            std::string category = GetEventCategory(type);
+            auto it = std::find_if(m_eventTypes.begin(), m_eventTypes.end(),
+                                   [&category](const auto& entry) { return entry.first == category; });
+            if (it == m_eventTypes.end())
+            {
+                m_eventTypes.emplace_back(category, count);
+            }
+            else
+            {
+                it->second += count;
+            }
+        }
+        std::sort(m_eventTypes.begin(), m_eventTypes.end(),
+                  [](const auto& a, const auto& b) { return a.second > b.second; });
+    }
+
+    /**
+     * The profile as named values, for the results: <phase>WallTime, events, eventsPerSecond,
+     * simulatedSecondsPerSecond and events<Category>.
+     */
+    std::vector<std::pair<std::string, double>> GetValues() const
+    {
+        std::vector<std::pair<std::string, double>> values;
+        for (const auto& [phase, wallTime] : m_phases)
+        {
+            values.emplace_back(phase + "WallTime", wallTime);
+        }
+        values.emplace_back("events", m_events);
+        if (m_runWallTime > 0)
+        {
+            values.emplace_back("eventsPerSecond", m_events / m_runWallTime);
+            values.emplace_back("simulatedSecondsPerSecond", m_simulatedTime / m_runWallTime);
+        }
+        for (const auto& [category, count] : m_eventTypes)
+        {
+            values.emplace_back("events" + category, count);
+        }
+        return values;
+    }
+
+    /**
+     * Print the profile, one "PROFILE ..." line per value.
+     */
+    void Print(std::ostream& os) const
+    {
+        for (const auto& [phase, wallTime] : m_phases)
+        {
+            os << "PROFILE " << phase << ": " << wallTime << " s" << std::endl;
+        }
+        os << "PROFILE events: " << m_events;
+        if (m_runWallTime > 0)
+        {
+            os << " (" << m_events / m_runWallTime << " events/s, " << m_simulatedTime / m_runWallTime
+               << " simulated s/s)";
+        }
+        os << std::endl;
+        for (const auto& [category, count] : m_eventTypes)
+        {
+            os << "PROFILE events " << category << ": " << count << " ("
+               << (m_events > 0 ? 100.0 * count / m_events : 0) << "%)" << std::endl;
+        }
+    }
+
+  private:
+    std::vector<std::pair<std::string, double>> m_phases; // In the order they ran.
+    std::string m_phase;                                  // The running phase, if any.
+    std::chrono::steady_clock::time_point m_phaseStart;
+    uint64_t m_events = 0;
+    double m_runWallTime = 0;
+    double m_simulatedTime = 0;
+    std::vector<std::pair<std::string, uint64_t>> m_eventTypes; // By decreasing count.
+};
+
+} // namespace ns3
+
+#endif /* SIMULATION_PROFILE_H */
@@ -0,0 +1,186 @@
+#ifndef THROUGHPUT_SAMPLER_H
+#define THROUGHPUT_SAMPLER_H
+
+#include "kpi-statistics.h"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+/**
+ * The throughput time series of a flow, sampled at its sink.
+ *
+ * The received bytes are binned into fixed intervals of simulated time, in a ring buffer that is allocated
+ * once: AddBytes, called by the scenario as the flow receives data, only adds to the current bin, and zeroes the
+ * bins it skips. When the simulation is
+ * longer than the buffer, the oldest bins are overwritten, and the series covers the last capacity intervals.
+ *
+ * The steady state of the series starts at its MSER truncation point (see kpi-statistics.h), which leaves out
+ * the slow-start of the flow, and the time before it starts. The confidence interval of the steady-state
+ * throughput is computed by batch means, as the throughput of consecutive intervals is correlated.
+ */
+
+namespace ns3
+{
+
+/**
+ * The throughput of one interval.
+ */
+struct ThroughputSample
+{
+    double time;       // The start of the interval, in seconds.
+    double throughput; // In Mbps.
+};
+
+/**
+ * The steady-state part of a throughput time series.
+ */
+struct SteadyStateThroughput
+{
+    double start;                // The start of the steady state, in seconds.
+    double throughput;           // The mean throughput of the steady state, in Mbps.
+    double confidenceInterval95; // The half-width of the 95% confidence interval of the throughput, in Mbps.
+};
+
+/**
+ * The mean throughput of the samples of a series that start in [from, to), in Mbps (NaN if there are none).
+ */
+inline double
+GetMeanThroughput(const std::vector<ThroughputSample>& series, double from, double to)
+{
+    RunningStatistics throughput;
+    for (const ThroughputSample& sample : series)
+    {
+        if (sample.time >= from && sample.time < to)
+        {
+            throughput.Add(sample.throughput);
+        }
+    }
+    return throughput.GetCount() > 0 ? throughput.GetMean() : std::numeric_limits<double>::quiet_NaN();
+}
+
+class ThroughputSampler
+{
+  public:
+    /**
+     * \param interval the duration of a bin.
+     * \param capacity the number of bins kept.
+     */
+    ThroughputSampler(Time interval, uint32_t capacity)
+        : m_interval(interval.GetInteger()),
+          m_bins(capacity, 0)
+    {
+        NS_ABORT_MSG_IF(m_interval <= 0, "The sampling interval must be positive");
+        NS_ABORT_MSG_IF(capacity == 0, "The sampler needs at least one bin");
+    }
+
+    ThroughputSampler(const ThroughputSampler&) = delete;
+    ThroughputSampler& operator=(const ThroughputSampler&) = delete;
+
+    /**
+     * Count bytes received now.
+     */
+    void AddBytes(uint64_t bytes)
+    {
+        uint64_t bin = Simulator::Now().GetInteger() / m_interval;
+        AdvanceTo(bin);
+        m_bins[bin % m_bins.size()] += bytes;
+    }
+
+    /**
+     * The throughput of the intervals kept, up to the given end of the measurement (usually the end of
+     * the simulation). The last interval may be shorter than the others.
+     */
+    std::vector<ThroughputSample> GetTimeSeries(Time end) const
+    {
+        std::vector<ThroughputSample> series;
+        int64_t endStep = end.GetInteger();
+        if (endStep <= 0)
+        {
+            return series;
+        }
+        uint64_t lastBin = (endStep - 1) / m_interval;
+        uint64_t firstBin = lastBin + 1 > m_bins.size() ? lastBin + 1 - m_bins.size() : 0;
+        for (uint64_t bin = firstBin; bin <= lastBin; ++bin)
+        {
+            int64_t binStart = bin * m_interval;
+            int64_t binDuration = std::min<int64_t>(m_interval, endStep - binStart);
+            double seconds = TimeStep(binDuration).GetSeconds();
+            series.push_back({TimeStep(binStart).GetSeconds(), GetBytes(bin) * 8.0 / seconds / 1e6});
+        }
+        return series;
+    }
+
+    /**
+     * The steady-state throughput of the intervals kept, up to the given end of the measurement.
+     */
+    SteadyStateThroughput GetSteadyState(Time end) const
+    {
+        std::vector<ThroughputSample> series = GetTimeSeries(end);
+        if (series.empty())
+        {
+            return {0, 0, std::numeric_limits<double>::infinity()};
+        }
+        std::vector<double> throughputs;
+        for (const ThroughputSample& sample : series)
+        {
+            throughputs.push_back(sample.throughput);
+        }
+        size_t truncation = MserTruncationPoint(throughputs);
+        RunningStatistics steadyState;
+        for (size_t i = truncation; i < throughputs.size(); ++i)
+        {
+            steadyState.Add(throughputs[i]);
+        }
+        return {series[truncation].time,
+                steadyState.GetMean(),
+                BatchMeansConfidenceInterval95(throughputs, truncation)};
+    }
+
+  private:
+    /**
+     * Make the given bin the current one, zeroing the bins in between.
+     */
+    void AdvanceTo(uint64_t bin)
+    {
+        if (bin <= m_currentBin)
+        {
+            return;
+        }
+        if (bin - m_currentBin >= m_bins.size())
+        {
+            std::fill(m_bins.begin(), m_bins.end(), 0);
+        }
+        else
+        {
+            for (uint64_t skipped = m_currentBin + 1; skipped <= bin; ++skipped)
+            {
+                m_bins[skipped % m_bins.size()] = 0;
+            }
+        }
+        m_currentBin = bin;
+    }
+
+    /**
+     * The bytes received in a bin: zero if it was not reached yet, or if it was overwritten.
+     */
+    uint64_t GetBytes(uint64_t bin) const
+    {
+        if (bin > m_currentBin || bin + m_bins.size() <= m_currentBin)
+        {
+            return 0;
+        }
+        return m_bins[bin % m_bins.size()];
+    }
+
+    int64_t m_interval;           // In time steps.
+    std::vector<uint64_t> m_bins; // Received bytes, bin i at index i % capacity.
+    uint64_t m_currentBin = 0;    // The latest bin reached.
+};
+
+} // namespace ns3
+
+#endif /* THROUGHPUT_SAMPLER_H */
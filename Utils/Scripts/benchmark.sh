@@ -0,0 +1,109 @@
+#!/bin/zsh
+
+# Measures how fast the programs of Simulations/ run, and compares it with a stored baseline, to catch the
+# performance regressions of ns-3 or QUIC module upgrades before they reach the sweeps.
+#
+# Every benchmark runs a program with fixed parameters, seed and run, so that it simulates the same events
+# every time. It records the wall time (the fastest of the repetitions), the simulated seconds per wall-clock
+# second, the number of events and the events per second (from --profile, see Simulations/simulation-profile.h),
+# and the peak RSS (from GNU time).
+#
+#   benchmark.sh --update   measures, and stores the results as the baseline
+#   benchmark.sh            measures, and compares with the baseline: exits with an error if a benchmark is
+#                           slower or bigger than the baseline by more than the tolerance
+#
+# BENCHMARK_BASELINE (default: benchmark-baseline.txt), BENCHMARK_REPEATS (default: 3) and BENCHMARK_TOLERANCE
+# (default: 0.1, i.e. +10%) change the defaults. A baseline is only meaningful on the machine it was measured on.
+# A different number of events means that the simulated model changed, not just its speed: it is reported,
+# but it is not an error.
+#
+# Like the other scripts, it is run from the ns-3 directory, with Simulations/ copied into scratch/.
+
+benchmarks=(
+  "Throughput-TCP-over-LTE --distance=250"
+  "Throughput-QUIC-over-LTE --distance=250"
+  "DLT-TCP-over-LTE --fileSize=1MB"
+  "DLT-QUIC-over-LTE --fileSize=1MB"
+  "Fairness-over-LTE --tcpFlows=5"
+  "Throughput-QUIC-Streams-over-LTE --streams=4"
+  "Throughput-QUIC-Connections-over-LTE --connections=2"
+  "Handover-over-LTE --ues=20 --simulationDuration=10"
+)
+
+update=0
+if [ "$1" = "--update" ]; then
+  update=1
+elif [ -n "$1" ]; then
+  echo "Usage: $0 [--update]"
+  exit 1
+fi
+baseline=${BENCHMARK_BASELINE:-benchmark-baseline.txt}
+repeats=${BENCHMARK_REPEATS:-3}
+tolerance=${BENCHMARK_TOLERANCE:-0.1}
+
+if [ $update -eq 0 ] && [ ! -f "$baseline" ]; then
+  echo "Error: no baseline $baseline, run $0 --update first."
+  exit 1
+fi
+if [ ! -x /usr/bin/time ]; then
+  echo "Error: GNU time (/usr/bin/time) is needed to measure the peak RSS."
+  exit 1
+fi
+if ! ./ns3 build > /dev/null; then
+  echo "Error: the build failed."
+  exit 1
+fi
+
+# One line per benchmark: <name> <wall time (s)> <simulated s/s> <events> <events/s> <peak RSS (kB)>
+results=$(mktemp)
+for benchmark in "${benchmarks[@]}"; do
+  name=${benchmark// /_}
+  best=""
+  for ((repeat = 0; repeat < repeats; repeat++)); do
+    log=$(./ns3 run --no-build --command-template="/usr/bin/time -f 'BENCHMARK %e %M' %s" \
+          "$benchmark --seed=1 --run=1 --profile" 2>&1 > /dev/null)
+    measure=$(echo "$log" | awk '
+      /^BENCHMARK/ { wallTime = $2; rss = $3 }
+      /^PROFILE events:/ { events = $3; rate = substr($4, 2); simulated = $6 }
+      END { if (wallTime != "" && events != "") print wallTime, simulated, events, rate, rss }')
+    if [ -z "$measure" ]; then
+      echo "Error: benchmark $benchmark failed:"
+      echo "$log"
+      exit 1
+    fi
+    # The fastest repetition is the least disturbed by the rest of the machine:
+    if [ -z "$best" ] || [ "$(echo "$measure $best" | awk '{print ($1 < $6)}')" = 1 ]; then
+      best=$measure
+    fi
+  done
+  echo "$name $best" >> "$results"
+done
+
+if [ $update -eq 1 ]; then
+  mv "$results" "$baseline"
+  echo "Baseline stored in $baseline:"
+  cat "$baseline"
+  exit 0
+fi
+
+awk -v tolerance="$tolerance" '
+  FNR == NR { wallTime[$1] = $2; events[$1] = $4; rss[$1] = $6; next }
+  {
+    printf "%s: %.2f s (%.2f simulated s/s, %d events, %.0f events/s), peak RSS %.1f MB", $1, $2, $3, $4, $5, $6 / 1024
+    if (!($1 in wallTime)) { print " [NOT IN BASELINE]"; next }
+    printf " [baseline %.2f s, %+.1f%%; %.1f MB, %+.1f%%]", wallTime[$1], 100 * ($2 / wallTime[$1] - 1),
+           rss[$1] / 1024, 100 * ($6 / rss[$1] - 1)
+    status = ""
+    if ($2 > wallTime[$1] * (1 + tolerance)) { status = status " SLOWER"; failed++ }
+    if ($6 > rss[$1] * (1 + tolerance)) { status = status " BIGGER"; failed++ }
+    if ($4 != events[$1]) { status = status " EVENTS CHANGED" }
+    print status == "" ? " OK" : status
+  }
+  END { exit failed > 0 }' "$baseline" "$results"
+status=$?
+rm -f "$results"
+if [ $status -ne 0 ]; then
+  echo "Error: performance regression against $baseline (tolerance +$(awk -v t="$tolerance" 'BEGIN {print 100 * t}')%)."
+  exit 1
+fi
+echo "No performance regression against $baseline."
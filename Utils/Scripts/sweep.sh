@@ -0,0 +1,147 @@
+#!/bin/zsh
+
+# Runs every program of Simulations/ over the grid the Results/*.xlsx sheets are built from,
+# spreading the replications over a pool of worker processes, and gathers all the results into one KPI table
+# (see Simulations/kpi-table.h): a row per replication, with its program, parameters, seed, run and KPIs.
+# Summarize it with Utils/Tools/kpi-reader.cc:
+#   kpi-reader sweep-results.kpi         (mean, std. dev. and CI of every KPI of every grid point)
+#   kpi-reader --csv sweep-results.kpi   (all the rows)
+#
+# Every job is one process that runs a block of replications in-process. Job j of a grid point runs with
+# --job=j, which gives it its own block of run numbers of the sweep seed (see Simulations/replication-runner.h):
+# the replications of a grid point are independent, and the results do not depend on the number of workers
+# or on the order the jobs complete in. Its trace files, if the arguments enable any, are prefixed with
+# <program>-<grid point>-<job>- (--tracePrefix), so that the jobs do not overwrite each other's.
+#
+# With SWEEP_DLT_BATCH=1, each DLT job downloads all the file sizes one after another in one simulation
+# (--fileSizes), instead of running one simulation per file size.
+#
+# With SWEEP_CC=1, the grid is the congestion control matrix instead: the throughput and the DLT of TCP with each
+# of SWEEP_TCP_CC, of QUIC with each of SWEEP_QUIC_CC (default for both: NewReno Cubic Bbr), and the fairness of
+# 1 QUIC flow vs 5 TCP flows for every pair of them. The congestion controls are parameters of the results
+# (tcpCongestionControl, quicCongestionControl), so kpi-reader summarizes every cell of the matrix.
+#
+# With SWEEP_LOSS=1, the grid is the loss sweep instead: the TCP and QUIC throughput and the fairness of 1 QUIC flow
+# vs 5 TCP flows for every loss model of SWEEP_LOSS_MODELS (default: rate gilbert-elliott) at every loss rate of
+# SWEEP_LOSS_RATES (default: 0.001 0.005 0.01 0.02 0.05) of the Internet links.
+#
+# Like the other scripts, it is run from the ns-3 directory, with Simulations/ copied into scratch/.
+
+# A single job, started by xargs:
+#   sweep.sh --job <seed> <job> <replications> <output dir> <index> <grid point> <program> [args...]
+if [ "$1" = "--job" ]; then
+  seed=$2 job=$3 replications=$4 outputDir=$5 index=$6 point=$7 program=$8
+  shift 8
+  if ! ./ns3 run --no-build "$program $* --seed=$seed --job=$job --replications=$replications --results=$outputDir/job-$index.kpi --tracePrefix=$program-$point-$job-" > "$outputDir/job-$index.log" 2>&1; then
+    echo "Error: job $index ($program $*) failed, see $outputDir/job-$index.log"
+    exit 1
+  fi
+  exit 0
+fi
+
+if [ -z "$1" ]; then
+  echo "Usage: $0 <replications> [workers (default: all cores)] [replications per process (default: 1)] [output file (default: sweep-results.kpi)]"
+  echo "The replications are rounded up to a multiple of the replications per process."
+  exit 1
+fi
+
+replications=$1
+workers=${2:-$(nproc)}
+perProcess=${3:-1}
+output=${4:-sweep-results.kpi}
+seed=${SWEEP_SEED:-1}
+
+for value in "$replications" "$workers" "$perProcess"; do
+  if ! [[ "$value" =~ ^[0-9]+$ ]] || [ "$value" -eq 0 ]; then
+    echo "Error: The number of replications, workers and replications per process must be positive integers."
+    exit 1
+  fi
+done
+
+# The grid of the Results/*.xlsx sheets, and the number of QUIC streams (KPI 4):
+distances=(250 750 1500 2500)
+fileSizes=(64KB 256KB 512KB 1MB 2MB 3MB 5MB 10MB 15MB 20MB 25MB)
+internetDataRates=(1Gbps 2Mbps)
+
+gridPoints=()
+if [ "${SWEEP_CC:-0}" = 1 ]; then
+  tcpCcs=(${=${SWEEP_TCP_CC:-NewReno Cubic Bbr}})
+  quicCcs=(${=${SWEEP_QUIC_CC:-NewReno Cubic Bbr}})
+  for tcpCc in "${tcpCcs[@]}"; do
+    gridPoints+=("Throughput-TCP-over-LTE --distance=250 --tcpCongestionControl=$tcpCc")
+    gridPoints+=("DLT-TCP-over-LTE --fileSize=5MB --tcpCongestionControl=$tcpCc")
+  done
+  for quicCc in "${quicCcs[@]}"; do
+    gridPoints+=("Throughput-QUIC-over-LTE --distance=250 --quicCongestionControl=$quicCc")
+    gridPoints+=("DLT-QUIC-over-LTE --fileSize=5MB --quicCongestionControl=$quicCc")
+    for tcpCc in "${tcpCcs[@]}"; do
+      gridPoints+=("Fairness-over-LTE --tcpFlows=5 --tcpCongestionControl=$tcpCc --quicCongestionControl=$quicCc")
+    done
+  done
+elif [ "${SWEEP_LOSS:-0}" = 1 ]; then
+  lossModels=(${=${SWEEP_LOSS_MODELS:-rate gilbert-elliott}})
+  errorRates=(${=${SWEEP_LOSS_RATES:-0.001 0.005 0.01 0.02 0.05}})
+  for lossModel in "${lossModels[@]}"; do
+    for errorRate in "${errorRates[@]}"; do
+      loss="--lossModel=$lossModel --errorRate=$errorRate"
+      gridPoints+=("Throughput-TCP-over-LTE --distance=250 $loss")
+      gridPoints+=("Throughput-QUIC-over-LTE --distance=250 $loss")
+      gridPoints+=("Fairness-over-LTE --tcpFlows=5 $loss")
+    done
+  done
+else
+  for protocol in TCP QUIC; do
+    for distance in "${distances[@]}"; do
+      gridPoints+=("Throughput-$protocol-over-LTE --distance=$distance")
+    done
+    if [ "${SWEEP_DLT_BATCH:-0}" = 1 ]; then
+      # The simulation stops when the last file is received, so a long cap only matters at the far distances:
+      gridPoints+=("DLT-$protocol-over-LTE --fileSizes=$(IFS=,; echo "${fileSizes[*]}") --simulationDuration=400")
+    else
+      for fileSize in "${fileSizes[@]}"; do
+        gridPoints+=("DLT-$protocol-over-LTE --fileSize=$fileSize")
+      done
+    fi
+  done
+  for streams in 1 2 4 8; do
+    gridPoints+=("Throughput-QUIC-Streams-over-LTE --streams=$streams")
+  done
+  for tcpFlows in 2 5; do
+    for internetDataRate in "${internetDataRates[@]}"; do
+      gridPoints+=("Fairness-over-LTE --tcpFlows=$tcpFlows --internetDataRate=$internetDataRate")
+    done
+  done
+fi
+
+# Build once, so that the workers do not race on the build:
+if ! ./ns3 build > /dev/null; then
+  echo "Error: the build failed."
+  exit 1
+fi
+
+outputDir=$(mktemp -d)
+jobsPerGridPoint=$(((replications + perProcess - 1) / perProcess))
+jobs=$((${#gridPoints[@]} * jobsPerGridPoint))
+index=0
+point=0
+for gridPoint in "${gridPoints[@]}"; do
+  for ((job = 0; job < jobsPerGridPoint; job++)); do
+    echo "$seed $job $perProcess $outputDir $index $point $gridPoint"
+    index=$((index + 1))
+  done
+  point=$((point + 1))
+done | xargs -P "$workers" -L 1 "$0" --job
+status=$?
+
+# A KPI table is a sequence of row groups, so the tables of the jobs are merged by concatenating them:
+: > "$output"
+for ((index = 0; index < jobs; index++)); do
+  cat "$outputDir/job-$index.kpi" >> "$output" 2> /dev/null
+done
+
+if [ $status -ne 0 ]; then
+  echo "Error: some jobs failed, their results are missing from $output (logs in $outputDir)."
+  exit 1
+fi
+rm -rf "$outputDir"
+echo "Sweep done [$((jobsPerGridPoint * perProcess)) replications per grid point, $jobs jobs, $workers workers]: results in $output."
@@ -6,8 +6,7 @@ if [ -z "$1" ]; then
   exit 1
 fi
 
-# Initialize sum and n
-sum=0
+# Initialize n
 n=$1
 fileSize=$2
 
@@ -17,22 +16,25 @@ if ! [[ "$n" =~ ^[0-9]+$ ]]; then
   exit 1
 fi
 
-for i in $(seq 1 $n); do
-  # Execute the command and capture its output
-  output=$(./ns3 run DLT-TCP-over-LTE -- --fileSize=$fileSize)
+# Run all the iterations as replications of a single process, which prints one result per line,
+# followed by an "AVERAGE dlt: <mean> STDDEV: ..." line when there is more than one replication.
+output=$(./ns3 run DLT-TCP-over-LTE -- --fileSize=$fileSize --replications=$n)
+results=$(echo "$output" | grep -v '^AVERAGE')
 
-  # Check if output is a valid number
-  if [[ $output =~ ^-?[0-9]+(\.[0-9]+)?$ ]]; then
-    # Use bc to add the output to sum, handling floating-point numbers
-    sum=$(echo "$sum + $output" | bc)
-  else
+# Check that every replication output a valid number
+for result in ${(f)results}; do
+  if ! [[ $result =~ ^-?[0-9]+(\.[0-9]+)?(e-?[0-9]+)?$ ]]; then
     echo "Error: Program output is not a valid number. Received program output:"
     echo $output
     exit 1
   fi
 done
 
-# Calculate the average using bc for floating-point division
-average=$(echo "scale=2; $sum / $n" | bc)
+# Take the average from the aggregate line (a single replication is its own average)
+if [ "$n" -eq 1 ]; then
+  average=$(printf "%.2f" $results)
+else
+  average=$(echo "$output" | awk '/^AVERAGE dlt:/ {printf "%.2f", $3}')
+fi
 
 echo "Average TCP DLT [$n simulations, file size = $fileSize]: $average seconds."
@@ -0,0 +1,103 @@
+#!/bin/zsh
+
+# Validates the distributed simulation (--distributed, ns-3 built with MPI) against the single-process one:
+# runs the replications of a program both ways, with the same seed and run numbers, and compares every KPI the
+# program prints (its throughputs, "JAIN INDEX: ...", ...) run by run. It prints the single-process and the
+# distributed value of every run, and checks that the mean of their per-run differences is within its 95%
+# confidence interval of zero (a paired test: a run uses the same random numbers both ways).
+# The ranks do not share the error model of the Internet links, so the runs are not identical in general. With
+# VALIDATE_EXACT=1, for the arguments that make them identical (e.g. --errorRate=0), every per-run value must
+# also match within a relative 1e-6.
+#
+# Like the other scripts, it is run from the ns-3 directory, with Simulations/ copied into scratch/.
+
+if [ -z "$2" ]; then
+  echo "Usage: $0 <replications> <ranks> [program and arguments (default: Fairness-over-LTE)]"
+  exit 1
+fi
+
+replications=$1
+ranks=$2
+shift 2
+program=${*:-Fairness-over-LTE}
+seed=${VALIDATE_SEED:-1}
+exact=${VALIDATE_EXACT:-0}
+
+for value in "$replications" "$ranks"; do
+  if ! [[ "$value" =~ ^[0-9]+$ ]] || [ "$value" -lt 2 ]; then
+    echo "Error: At least 2 replications and 2 ranks are needed."
+    exit 1
+  fi
+done
+
+if ! ./ns3 build > /dev/null; then
+  echo "Error: the build failed."
+  exit 1
+fi
+
+# Every line of the output of the program is a "<KPI>: <value>", or the bare throughput of a throughput program.
+# The replications print their KPIs in turn, from the given run on: "<mode> <KPI> <run> <value>".
+kpis() {
+  awk -v mode="$1" -v first="$2" '
+    function emit(key, value) { print mode, key, first + seen[key]++, value }
+    /^AVERAGE/ { next }
+    /^-?[0-9.]+(e-?[0-9]+)?$/ { emit("THROUGHPUT", $1); next }
+    /: -?[0-9.]+(e-?[0-9]+)?$/ { value = $NF; sub(/: [^:]*$/, ""); gsub(/ /, "_"); emit($0, value) }'
+}
+
+results=$(mktemp)
+if ! ./ns3 run --no-build "$program --seed=$seed --run=1 --replications=$replications" | kpis single 1 >> "$results"; then
+  echo "Error: the single-process run failed."
+  exit 1
+fi
+for ((run = 1; run <= replications; run++)); do
+  if ! ./ns3 run --no-build "$program --seed=$seed --run=$run --distributed" \
+       --command-template="mpiexec -np $ranks %s" | kpis distributed $run >> "$results"; then
+    echo "Error: the distributed run $run failed."
+    exit 1
+  fi
+done
+
+awk -v replications="$replications" -v exact="$exact" '
+  { value[$1, $2, $3] = $4; keys[$2] = 1 }
+  END {
+    failed = 0
+    for (key in keys) {
+      n = 0; sum = 0; squares = 0
+      for (run = 1; run <= replications; run++) {
+        if (!(("single", key, run) in value) || !(("distributed", key, run) in value)) {
+          printf "%s run %d: missing from the %s output MISMATCH\n", key, run,
+                 ("single", key, run) in value ? "distributed" : "single"
+          failed++
+          continue
+        }
+        single = value["single", key, run]
+        distributed = value["distributed", key, run]
+        difference = distributed - single
+        n++; sum += difference; squares += difference * difference
+        scale = single < 0 ? -single : single
+        ok = !exact || (difference <= 1e-6 * scale + 1e-12 && -difference <= 1e-6 * scale + 1e-12)
+        failed += !ok
+        printf "%s run %d: single %g distributed %g difference %g%s\n", key, run, single, distributed, difference,
+               ok ? "" : " MISMATCH"
+      }
+      if (n == 0) {
+        continue
+      }
+      mean = sum / n
+      variance = n > 1 ? (squares - n * mean ^ 2) / (n - 1) : 0
+      tolerance = variance > 0 ? 1.96 * sqrt(variance / n) : 0
+      ok = mean <= tolerance + 1e-9 && -mean <= tolerance + 1e-9
+      failed += !ok
+      printf "%s: mean difference %g (95%% CI +/- %g) over %d runs %s\n", key, mean, tolerance, n,
+             ok ? "OK" : "MISMATCH"
+    }
+    exit failed > 0
+  }' "$results"
+status=$?
+rm -f "$results"
+if [ $status -ne 0 ]; then
+  echo "Error: the distributed simulation of $program does not match the single-process one."
+  exit 1
+fi
+echo "The distributed simulation of $program [$ranks ranks, $replications replications] matches the single-process one."
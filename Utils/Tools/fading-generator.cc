@@ -0,0 +1,116 @@
+/**
+ * Generates synthetic fading traces (EPA, EVA or ETU at any Doppler frequency and length) in the binary form that the
+ * simulations map (see Simulations/fading-generator.h), and prints the file of the trace.
+ *
+ * Build (no ns-3 needed):
+ *   g++ -std=c++17 -O2 -I Simulations -o fading-generator Utils/Tools/fading-generator.cc
+ *
+ * Usage:
+ *   fading-generator [--profile=EPA|EVA|ETU] [--doppler=<Hz> | --speed=<km/h> [--frequency=<Hz>]]
+ *                    [--duration=<s>] [--interval=<s>] [--rbs=<n>] [--seed=<n>] [--cache=<dir> | --output=<file>]
+ *
+ * The trace is cached in --cache (fading-cache by default, the cache of the simulations run from the same directory)
+ * under a hash of its parameters, and only generated if it is not there yet; --output writes it to a given file
+ * instead. The simulations take the printed file as --fadingTrace. With the default interval, RBs and seed, they
+ * can also name the trace as <profile>:<doppler>:<duration> (e.g. --fadingTrace=EVA:70:60), which generates it on
+ * first use.
+ */
+
+#include "fading-generator.h"
+
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    const std::string usage = " [--profile=EPA|EVA|ETU] [--doppler=<Hz> | --speed=<km/h> [--frequency=<Hz>]]"
+                              " [--duration=<s>] [--interval=<s>] [--rbs=<n>] [--seed=<n>]"
+                              " [--cache=<dir> | --output=<file>]";
+    FadingTraceParameters parameters;
+    double speed = -1;
+    double frequency = 2.12e9;
+    std::string cache = "fading-cache";
+    std::string output;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            std::string value = arg.substr(arg.find('=') + 1);
+            if (arg.rfind("--profile=", 0) == 0)
+            {
+                parameters.profile = value;
+            }
+            else if (arg.rfind("--doppler=", 0) == 0)
+            {
+                parameters.doppler = std::stod(value);
+            }
+            else if (arg.rfind("--speed=", 0) == 0)
+            {
+                speed = std::stod(value);
+            }
+            else if (arg.rfind("--frequency=", 0) == 0)
+            {
+                frequency = std::stod(value);
+            }
+            else if (arg.rfind("--duration=", 0) == 0)
+            {
+                parameters.duration = std::stod(value);
+            }
+            else if (arg.rfind("--interval=", 0) == 0)
+            {
+                parameters.sampleInterval = std::stod(value);
+            }
+            else if (arg.rfind("--rbs=", 0) == 0)
+            {
+                parameters.rbNum = std::stoul(value);
+            }
+            else if (arg.rfind("--seed=", 0) == 0)
+            {
+                parameters.seed = std::stoull(value);
+            }
+            else if (arg.rfind("--cache=", 0) == 0)
+            {
+                cache = value;
+            }
+            else if (arg.rfind("--output=", 0) == 0)
+            {
+                output = value;
+            }
+            else
+            {
+                std::cout << "Usage: " << argv[0] << usage << std::endl;
+                return 1;
+            }
+        }
+        if (speed >= 0)
+        {
+            parameters.doppler = GetDopplerFrequency(speed, frequency);
+        }
+
+        if (output.empty())
+        {
+            std::cout << GetGeneratedFadingTrace(parameters, cache) << std::endl;
+        }
+        else
+        {
+            std::vector<float> gains = GenerateFadingTrace(parameters);
+            WriteFadingTrace(output,
+                             parameters.rbNum,
+                             gains.size() / parameters.rbNum,
+                             parameters.sampleInterval,
+                             gains,
+                             FADING_TRACE_CONTINUOUS);
+            std::cout << output << std::endl;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
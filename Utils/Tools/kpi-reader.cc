@@ -0,0 +1,207 @@
+/**
+ * Reads the KPI tables written by the simulations (--results=<file>, see Simulations/kpi-table.h),
+ * and prints them as CSV, or summarizes them.
+ *
+ * Build (no ns-3 needed):
+ *   g++ -std=c++17 -O2 -I Simulations -o kpi-reader Utils/Tools/kpi-reader.cc
+ *
+ * Usage:
+ *   kpi-reader [--csv] [--group-by=<column>,...] <file>...
+ *
+ * By default, the runs are grouped by their parameter columns (program, distance, fileSize, ...),
+ * and every KPI column is summarized by its mean, standard deviation and 95% confidence interval.
+ * --group-by replaces the parameter columns by the given ones. --csv prints all the rows instead.
+ */
+
+#include "kpi-statistics.h"
+#include "kpi-table.h"
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+void PrintCsv(const KpiTable& table);
+void PrintSummary(const KpiTable& table, std::vector<std::string> groupBy);
+std::vector<std::string> SplitColumns(const std::string& columns);
+std::string CsvField(const std::string& value);
+
+int
+main(int argc, char* argv[])
+{
+    bool csv = false;
+    bool groupBySet = false;
+    std::vector<std::string> groupBy;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--csv")
+        {
+            csv = true;
+        }
+        else if (arg.rfind("--group-by=", 0) == 0)
+        {
+            groupBy = SplitColumns(arg.substr(11));
+            groupBySet = true;
+        }
+        else if (arg.rfind("--", 0) == 0)
+        {
+            std::cout << "Usage: " << argv[0] << " [--csv] [--group-by=<column>,...] <file>..." << std::endl;
+            return 1;
+        }
+        else
+        {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty())
+    {
+        std::cout << "Usage: " << argv[0] << " [--csv] [--group-by=<column>,...] <file>..." << std::endl;
+        return 1;
+    }
+
+    KpiTable table;
+    try
+    {
+        for (const std::string& file : files)
+        {
+            table.Merge(KpiTable::ReadFrom(file));
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (csv)
+    {
+        PrintCsv(table);
+        return 0;
+    }
+    if (!groupBySet)
+    {
+        for (const KpiColumn& column : table.GetColumns())
+        {
+            if (column.role == KpiColumnRole::PARAMETER)
+            {
+                groupBy.push_back(column.name);
+            }
+        }
+    }
+    PrintSummary(table, groupBy);
+    return 0;
+}
+
+void
+PrintCsv(const KpiTable& table)
+{
+    const std::vector<KpiColumn>& columns = table.GetColumns();
+    for (size_t c = 0; c < columns.size(); ++c)
+    {
+        std::cout << (c ? "," : "") << CsvField(columns[c].name);
+    }
+    std::cout << '\n';
+    for (size_t row = 0; row < table.GetRows(); ++row)
+    {
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+            std::cout << (c ? "," : "") << CsvField(columns[c].ToString(row));
+        }
+        std::cout << '\n';
+    }
+}
+
+void
+PrintSummary(const KpiTable& table, std::vector<std::string> groupBy)
+{
+    std::vector<const KpiColumn*> keys;
+    for (const std::string& name : groupBy)
+    {
+        const KpiColumn* column = table.FindColumn(name);
+        if (column == nullptr)
+        {
+            std::cout << "ERROR: No column named " << name << std::endl;
+            exit(1);
+        }
+        keys.push_back(column);
+    }
+
+    // The statistics of every KPI of every group, with the groups in the order of their first row:
+    std::vector<std::string> groups;
+    std::map<std::string, std::map<std::string, RunningStatistics>> statistics;
+    for (size_t row = 0; row < table.GetRows(); ++row)
+    {
+        std::string group;
+        for (size_t k = 0; k < keys.size(); ++k)
+        {
+            group += (k ? "," : "") + CsvField(keys[k]->ToString(row));
+        }
+        if (statistics.find(group) == statistics.end())
+        {
+            groups.push_back(group);
+        }
+        std::map<std::string, RunningStatistics>& groupStatistics = statistics[group];
+        for (const KpiColumn& column : table.GetColumns())
+        {
+            if (column.role == KpiColumnRole::KPI && !column.IsMissing(row))
+            {
+                groupStatistics[column.name].Add(column.GetDouble(row));
+            }
+        }
+    }
+
+    for (const std::string& key : groupBy)
+    {
+        std::cout << CsvField(key) << ",";
+    }
+    std::cout << "kpi,mean,stddev,ci95,n" << '\n';
+    for (const std::string& group : groups)
+    {
+        for (const auto& [kpi, kpiStatistics] : statistics[group])
+        {
+            std::cout << group << (keys.empty() ? "" : ",") << CsvField(kpi) << "," << kpiStatistics.GetMean() << ","
+                      << kpiStatistics.GetStdDev() << "," << kpiStatistics.GetConfidenceInterval95() << ","
+                      << kpiStatistics.GetCount() << '\n';
+        }
+    }
+}
+
+std::vector<std::string>
+SplitColumns(const std::string& columns)
+{
+    std::vector<std::string> names;
+    size_t start = 0;
+    while (start <= columns.size())
+    {
+        size_t end = columns.find(',', start);
+        if (end == std::string::npos)
+        {
+            end = columns.size();
+        }
+        if (end > start)
+        {
+            names.push_back(columns.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return names;
+}
+
+std::string
+CsvField(const std::string& value)
+{
+    if (value.find_first_of(",\"\n") == std::string::npos)
+    {
+        return value;
+    }
+    std::string quoted = "\"";
+    for (char c : value)
+    {
+        quoted += c == '"' ? "\"\"" : std::string(1, c);
+    }
+    return quoted + "\"";
+}